@@ -4,7 +4,7 @@ import matplotlib as mpl
 from matplotlib import pyplot as plt
 from matplotlib import colormaps as cm
 import imageio
-import qupled.classic as qpc
+import qupled.qupled as qp
 import qupled.quantum as qpq
 
 darkmode = False
@@ -22,23 +22,24 @@ labelsz = 16
 ticksz = 14
 width = 2.0
 
-def solve_qstls(i):
-    qstls = qpq.Qstls(15.0, 1.0,
-                      mixing = 0.3,
-                      resolution = 0.1,
-                      cutoff = 10,
-                      matsubara = 16,
-                      threads = 16,
-                      iterations = 0)
-    if (i > 0):
-        qstls.setGuess("rs15.000_theta1.000_QSTLS.h5")
-    qstls.inputs.fixed = "adr_fixed_rs15.000_theta1.000_QSTLS.bin"
-    qstls.compute()
-    return [qstls.scheme.wvg,
-            qstls.scheme.adr,
-            qstls.scheme.idr,
-            qstls.scheme.ssf,
-            qstls.scheme.error]
+def init_qstls():
+    inputs = qpq.Qstls(15.0, 1.0,
+                       mixing = 0.3,
+                       resolution = 0.1,
+                       cutoff = 10,
+                       matsubara = 16,
+                       threads = 16).inputs
+    qstls = qp.Qstls(inputs)
+    qstls.init()
+    return qstls
+
+def solve_qstls(qstls):
+    qstls.step(1)
+    return [qstls.wvg,
+            qstls.adr,
+            qstls.idr,
+            qstls.ssf,
+            qstls.state()["error"]]
 
 def plot_ssf(plt, wvg, ssf):
     plt.subplot(2, 2, 4)
@@ -88,8 +89,8 @@ def plot_error(plt, iteration, errorList, error):
     plt.xticks(fontsize=ticksz)
     plt.yticks(fontsize=ticksz)
     
-def create_plot(i, errorList):
-    [wvg, adr, idr, ssf, error] = solve_qstls(i)
+def create_plot(qstls, i, errorList):
+    [wvg, adr, idr, ssf, error] = solve_qstls(qstls)
     plt.figure(figsize=(12, 8))
     plt.style.use(theme)
     plot_density_response(plt, wvg, adr, idr)
@@ -104,8 +105,9 @@ def create_plot(i, errorList):
 fig, ax = plt.subplots()
 images = []
 error = []
+qstls = init_qstls()
 for i in range(nIterations):
-    plotName = create_plot(i, error)
+    plotName = create_plot(qstls, i, error)
     images.append(imageio.v2.imread(plotName)) 
     os.remove(plotName)
 imageio.mimsave(animationFile, images, fps=4)
@@ -123,6 +123,9 @@ protected:
   double aMix;
   // Minimum error for convergence in the iterative procedure
   double errMin;
+  // Ratio between the accuracy of the integrals and the residual error
+  // in the iterative procedure (zero to always use the input accuracy)
+  double intErrScaling;
   // Maximum number of iterations
   int nIter;
   // Output frequency
@@ -137,11 +140,12 @@ protected:
 public:
 
   // Contructor
-  StlsInput() : aMix(0), errMin(0), nIter(0),
+  StlsInput() : aMix(0), errMin(0), intErrScaling(0), nIter(0),
 		outIter(0), IETMapping(""),
 		recoveryFileName("") { ; }
   // Setters
   void setErrMin(const double &errMin);
+  void setIntErrorScaling(const double &intErrScaling);
   void setMixingParameter(const double  &aMix);
   void setIETMapping(const std::string &IETMapping);
   void setNIter(const int &nIter);
@@ -151,6 +155,7 @@ public:
   // Getters
   double getErrMin() const { return errMin; }
   std::string getIETMapping() const { return IETMapping; }
+  double getIntErrorScaling() const { return intErrScaling; }
   double getMixingParameter() const { return aMix; }
   int getNIter() const { return nIter; }
   int getOutIter() const { return outIter; }
@@ -189,20 +194,35 @@ private:
   std::string fixed;
   // Name of the file with the fixed component of the adr for iet schemes
   std::string fixedIet;
+  // Precision used to write the fixed components of the adr to file
+  std::string fixedPrecision;
+  // Relative error of the low-rank representation of the fixed
+  // components of the adr (zero to use the full representation)
+  double fixedRankErr;
+  // Interval in seconds between the progress reports printed while
+  // the fixed components of the adr are computed (zero to disable)
+  double progressInterval;
   // Initial guess
   QstlsGuess guess;
 
 public:
 
   // Contructors
-  QstlsInput() : fixed(""), fixedIet("") { ; }
+  QstlsInput() : fixed(""), fixedIet(""), fixedPrecision("double"),
+		 fixedRankErr(0), progressInterval(0) { ; }
   // Setters
   void setFixed(const std::string &fixed);
   void setFixedIet(const std::string &fixedIet);
+  void setFixedPrecision(const std::string &fixedPrecision);
+  void setFixedLowRankError(const double &fixedRankErr);
+  void setProgressInterval(const double &progressInterval);
   void setGuess(const QstlsGuess &guess);
   // Getters
   std::string getFixed() const {return fixed; }
   std::string getFixedIet() const { return fixedIet; }
+  std::string getFixedPrecision() const { return fixedPrecision; }
+  double getFixedLowRankError() const { return fixedRankErr; }
+  double getProgressInterval() const { return progressInterval; }
   QstlsGuess getGuess() const { return guess; }
   // Print content of the data structure
   void print() const ;
@@ -236,10 +256,14 @@ private:
   double drs;
   // Resolution of the degeneracy parameter grid
   double dTheta;
+  // Resolution of the coupling parameter grid for the free energy
+  double drsFxc;
   // Minimum error for the iterations used to define the free parameter
   double errMinAlpha;
   // Maximum number of iterations used to define the free parameter
   int nIterAlpha;
+  // Number of groups of MPI ranks used to bracket the free parameter
+  int nAlphaGroups;
   // Pre-computed free energy integrand
   FreeEnergyIntegrand fxcIntegrand;
   
@@ -247,21 +271,25 @@ public:
 
   // Contructor
   VSInput() : alphaGuess(std::vector<double>(2, 0)),
-	      drs(0), dTheta(0), errMinAlpha(0),
-	      nIterAlpha(0) { ; }
+	      drs(0), dTheta(0), drsFxc(0), errMinAlpha(0),
+	      nIterAlpha(0), nAlphaGroups(1) { ; }
   // Setters
   void setAlphaGuess(const std::vector<double>  &alphaGuess);
   void setCouplingResolution(const double &drs);
   void setDegeneracyResolution(const double &dTheta);
+  void setFreeEnergyCouplingResolution(const double &drsFxc);
   void setErrMinAlpha(const double &errMinAlpha);
   void setNIterAlpha(const int& nIterAlpha);
+  void setAlphaGroups(const int& nAlphaGroups);
   void setFreeEnergyIntegrand(const FreeEnergyIntegrand &freeEnergyIntegrand);
   // Getters 
   std::vector<double> getAlphaGuess() const { return alphaGuess; }
   double getCouplingResolution() const { return drs; }
   double getDegeneracyResolution() const { return dTheta; }
+  double getFreeEnergyCouplingResolution() const { return drsFxc; }
   double getErrMinAlpha() const { return errMinAlpha; }
   double getNIterAlpha() const { return nIterAlpha; }
+  int getAlphaGroups() const { return nAlphaGroups; }
   FreeEnergyIntegrand getFreeEnergyIntegrand() const { return fxcIntegrand; }
   // Print content of the data structure
   void print() const;
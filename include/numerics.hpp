@@ -8,8 +8,6 @@
 #include <gsl/gsl_roots.h>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_spline.h>
-#include <gsl/gsl_interp2d.h>
-#include <gsl/gsl_spline2d.h>
 #include "util.hpp"
 
 // -----------------------------------------------------------------
@@ -91,25 +89,39 @@ public:
   
 };
 
-// Interpolator for 2D data
+// Bicubic interpolator for 2D data. As in gsl_interp2d_bicubic, the
+// derivatives at the grid points are obtained from natural cubic
+// splines along the rows and the columns of the grid. The sixteen
+// coefficients of each cell are stored next to each other and, for
+// uniform grids, the cell that contains a point is found without
+// searching. The evaluation does not modify the interpolator, so the
+// same interpolator can be used concurrently by different threads
 class Interpolator2D {
 
 private:
 
-  // Spline
-  gsl_spline2d *spline;
-  // Accelerator
-  gsl_interp_accel *xacc;
-  gsl_interp_accel *yacc;
-  // Size
-  size_t nx;
-  size_t ny;
+  // Grid
+  std::vector<double> xGrid;
+  std::vector<double> yGrid;
+  // Grid step (zero for grids that are not uniform)
+  double xStep;
+  double yStep;
+  // Coefficients of the bicubic polynomial in each cell
+  std::vector<double> coeff;
   // Setup interpolator
   void setup(const double &x,
 	     const double &y,
-	     const double &z,
-	     const int nx_,
-	     const int ny_);
+	     const vecUtil::MatrixView &z);
+  // Index of the cell that contains v
+  static size_t getCell(const std::vector<double> &grid,
+			const double &step,
+			const double &v);
+  // Interpolated value in cell (i, j)
+  double eval(const size_t i,
+	      const double &t,
+	      const size_t j,
+	      const double &u) const;
+  
 public:
 
   // Constructor
@@ -118,19 +130,27 @@ public:
 		 const double &z,
 		 const int nx_,
 		 const int ny_);
-  Interpolator2D(const Interpolator2D &it);
-  Interpolator2D();
-  // Destructor
-  ~Interpolator2D();
+  Interpolator2D(const double &x,
+		 const double &y,
+		 const vecUtil::MatrixView &z);
+  Interpolator2D() : xStep(0), yStep(0) { ; }
   // Reset
   void reset(const double &x,
 	     const double &y,
 	     const double &z,
 	     const int szx_,
 	     const int szy_);
+  // Reset with data z(i, j) at (x_i, y_j), stored with any layout
+  void reset(const double &x,
+	     const double &y,
+	     const vecUtil::MatrixView &z);
   // Evaluate
   double eval(const double& x,
 	      const double& y) const;
+  // Evaluate at (x, y[k]) for all the points in y
+  void eval(const double& x,
+	    const std::vector<double>& y,
+	    std::vector<double>& out) const;
 };
 
 // -----------------------------------------------------------------
@@ -231,7 +251,7 @@ private:
     // Integration workspace limit
     const size_t limit;
     // Accuracy
-    const double relErr;
+    double relErr;
     // Residual error
     double err;
     // Solution
@@ -249,6 +269,8 @@ private:
     double getSolution() const { return sol; }
     double getAccuracy() const { return relErr; }
     Type getType() const { return type; }
+    // Setters
+    void setAccuracy(const double& relErr_) { relErr = relErr_; }
     // Compute integral
     virtual void compute(const std::function<double(double)>& func,
 			 const Param& param) = 0;
@@ -327,6 +349,78 @@ public:
   double getSolution() const;
   double getAccuracy() const { return gslIntegrator->getAccuracy(); }
   Type getType() const { return gslIntegrator->getType(); }
+  // Setters
+  void setAccuracy(const double& relErr) { gslIntegrator->setAccuracy(relErr); }
+  
+};
+
+// -----------------------------------------------------------------
+// Class for fixed order Gauss-Legendre quadrature rules
+// -----------------------------------------------------------------
+
+class GaussLegendre {
+
+private:
+
+  // Nodes and weights in the reference interval [-1, 1]
+  std::vector<double> nodes;
+  std::vector<double> weights;
+  
+public:
+
+  // Constructor
+  GaussLegendre(const size_t n);
+  // Number of nodes
+  size_t size() const { return nodes.size(); }
+  // Append the nodes and the weights for the interval [a, b] to x and w
+  void map(const double& a,
+	   const double& b,
+	   std::vector<double>& x,
+	   std::vector<double>& w) const;
+  
+};
+
+// -----------------------------------------------------------------
+// Class for linear functionals of cubic spline interpolants
+// -----------------------------------------------------------------
+
+// The integral of kernel(x) * s(x) over the grid x, where s(x) is the
+// natural cubic spline that interpolates the data y (as in
+// Interpolator1D), is a linear combination of the data. The weights
+// are computed once so that the integral is evaluated as a dot product
+class SplineFunctional {
+
+public:
+
+  // Typedef
+  using Func = std::function<double(double)>;
+  
+private:
+
+  // Weights
+  std::vector<double> weights;
+  // Compute the weights from the moments of the kernel on each
+  // interval of the grid (four moments for each interval)
+  void setup(const std::vector<double>& x,
+	     const std::vector<double>& moments);
+  
+public:
+
+  // Constructor for the integral of s(x) (i.e. kernel = 1)
+  explicit SplineFunctional(const std::vector<double>& x);
+  // Constructor for a kernel that is smooth in each interval of the
+  // grid. The moments of the kernel are computed with a Gauss-Legendre
+  // rule with nNodes nodes in each interval
+  SplineFunctional(const std::vector<double>& x,
+		   const Func& kernel,
+		   const size_t nNodes);
+  SplineFunctional() { ; }
+  // Evaluate the functional for the data y - offset
+  double eval(const std::vector<double>& y,
+	      const double& offset = 0.0) const;
+  // Getters
+  const std::vector<double>& getWeights() const { return weights; }
+  bool empty() const { return weights.empty(); }
   
 };
 
@@ -396,5 +490,138 @@ public:
   
 };
 
+// -----------------------------------------------------------------
+// Classes to compute integrals of vector-valued functions
+// -----------------------------------------------------------------
+
+// All the components of the integrand are evaluated at the same nodes
+// of the 21-points Gauss-Kronrod rule from GSL and the intervals are
+// refined until all the components have converged (GSL provides only
+// adaptive integrators for scalar functions)
+class VectorIntegrator1D {
+
+public:
+
+  // Typedef
+  using Func = std::function<void(const double&, std::vector<double>&)>;
+  
+private:
+
+  // Maximum number of intervals
+  const size_t limit;
+  // Accuracy
+  const double relErr;
+  // Number of components
+  size_t n;
+  // Limits of the integration intervals
+  std::vector<double> a;
+  std::vector<double> b;
+  // Integral, error estimate and integral of the absolute value for
+  // each interval (stored component by component)
+  std::vector<double> intervalSol;
+  std::vector<double> intervalErr;
+  std::vector<double> intervalAbs;
+  // Nodes of the rule and values of all the components of the
+  // integrand at the nodes
+  std::vector<double> nodes;
+  std::vector<double> values;
+  // Solution
+  std::vector<double> sol;
+  // Apply the Gauss-Kronrod rule to one interval
+  void applyRule(const Func& func,
+		 const size_t i);
+  
+public:
+
+  // Constructor
+  VectorIntegrator1D(const double& relErr_) : limit(1000), relErr(relErr_), n(0) { ; }
+  // Compute integral of a function with n components
+  void compute(const Func& func,
+	       const Integrator1D::Param& param,
+	       const size_t n_);
+  // Getters
+  const std::vector<double>& getSolution() const { return sol; }
+  double getAccuracy() const { return relErr; }
+  
+};
+
+class VectorIntegrator2D {
+
+private:
+
+  // Typedef
+  using Func = VectorIntegrator1D::Func;
+  using Param = Integrator2D::Param;
+  // Level 1 integrator (outermost integral)
+  VectorIntegrator1D itg1;
+  // Level 2 integrator
+  VectorIntegrator1D itg2;
+  // Temporary variable for level 2 integration
+  double x;
+  
+public:
+
+  // Constructor
+  VectorIntegrator2D(const double& relErr) : itg1(relErr), itg2(relErr) { ; }
+  // Compute integral of a function with n1 components. The integrand
+  // is the product (component by component) of func1 and of the
+  // level 2 integral of func2. If func2 has only one component (n2 =
+  // 1), its integral multiplies all the components of func1
+  void compute(const Func& func1,
+	       const Func& func2,
+	       const Param& param,
+	       const std::vector<double>& xGrid,
+	       const size_t n1,
+	       const size_t n2);
+  // Getters
+  double getX() const { return x; };
+  const std::vector<double>& getSolution() const { return itg1.getSolution(); };
+  
+};
+
+// -----------------------------------------------------------------
+// Class for low-rank approximations of matrices
+// -----------------------------------------------------------------
+
+// A matrix with n1 rows and n2 columns is approximated as the sum of
+// rank products u_k v_k^T, obtained from the singular value
+// decomposition (one-sided Jacobi) of the matrix with the rows scaled
+// to unit maximum. The terms with the largest singular values are
+// retained until the error of each row, relative to the largest
+// element (in absolute value) of the row, is smaller than relErr
+class LowRankMatrix {
+
+private:
+
+  // Number of rows and columns
+  size_t n1;
+  size_t n2;
+  // Rank of the approximation
+  size_t rank;
+  // Left (rank x n1) and right (rank x n2) vectors
+  std::vector<double> u;
+  std::vector<double> v;
+  
+public:
+
+  // Constructors
+  LowRankMatrix(const vecUtil::MatrixView& a,
+		const double& relErr);
+  LowRankMatrix(const size_t n1_,
+		const size_t n2_,
+		const std::vector<double>& u_,
+		const std::vector<double>& v_);
+  LowRankMatrix() : n1(0), n2(0), rank(0) { ; }
+  // Write the full matrix (row-major order) to a
+  void get(double* a) const;
+  // Getters
+  bool empty() const { return n1 == 0; }
+  size_t getRank() const { return rank; }
+  const double* getU(const size_t k) const { return u.data() + k * n1; }
+  const double* getV(const size_t k) const { return v.data() + k * n2; }
+  const std::vector<double>& getU() const { return u; }
+  const std::vector<double>& getV() const { return v; }
+  
+};
 
 #endif
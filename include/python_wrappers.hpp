@@ -11,6 +11,11 @@
 // Forward declarations
 namespace boost {
   namespace python {
+    namespace api {
+      class object;
+    }
+    using api::object;
+    class dict;
     namespace numpy {
       class ndarray;
     }
@@ -127,6 +132,12 @@ public:
 class PyStls {
 public:
   static int compute(Stls& stls);
+  static int initialize(Stls& stls);
+  static int step(Stls& stls,
+		  const int nIter);
+  static bp::dict getState(const Stls& stls);
+  static void setCallback(Stls& stls,
+			  const bp::object& callback);
   static double getError(const Stls& stls);
   static bn::ndarray getBf(const Stls& stls);
 };
@@ -139,6 +150,7 @@ class PyVSStls {
 public:
   static int compute(VSStls& vsstls);
   static double getError(const VSStls &vsstls);
+  static double getAlpha(const VSStls &vsstls);
   static bn::ndarray getFreeEnergyIntegrand(const VSStls &vsstls);
   static bn::ndarray getFreeEnergyGrid(const VSStls &vsstls);
 };
@@ -151,6 +163,7 @@ class PyQVSStls {
 public:
   static int compute(QVSStls& qvsstls);
   static double getError(const QVSStls &qvsstls);
+  static double getAlpha(const QVSStls &qvsstls);
   static bn::ndarray getAdr(const QVSStls& qvsstls);
   static bn::ndarray getFreeEnergyIntegrand(const QVSStls &qvsstls);
   static bn::ndarray getFreeEnergyGrid(const QVSStls &qvsstls);
@@ -190,9 +203,20 @@ public:
 class PyMPI {
 public:
   static int rank() { return parallelUtil::MPI::rank(); }
+  static int numberOfRanks() { return parallelUtil::MPI::numberOfRanks(); }
   static bool isRoot() { return parallelUtil::MPI::isRoot(); }
   static void barrier() { return parallelUtil::MPI::barrier(); }
   static double timer() { return parallelUtil::MPI::timer(); }
+  static int splitCommunicator(const int color) {
+    return parallelUtil::MPI::splitCommunicator(color);
+  }
+  static void freeCommunicator(const int commId) {
+    parallelUtil::MPI::freeCommunicator(commId);
+  }
+  static int getCommunicator() { return parallelUtil::MPI::getCommunicator(); }
+  static void setCommunicator(const int commId) {
+    parallelUtil::MPI::setCommunicator(commId);
+  }
 };
 
 #endif
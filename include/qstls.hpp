@@ -2,6 +2,12 @@
 #define QSTLS_HPP
 
 #include <map>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include "stls.hpp"
 
 // Forward declarations
@@ -9,11 +15,18 @@ namespace vecUtil {
   class Vector2D;
   class Vector3D;
 }
+namespace parallelUtil {
+  namespace MPI {
+    class GatherRequest;
+  }
+}
 class QsltsInput;
 class Interpolator1D;
 class Interpolator2D;
 class Integrator1D;
 class Integrator2D;
+class LowRankMatrix;
+class AdrFixedIetData;
 
 // -----------------------------------------------------------------
 // Solver for the qSTLS-based schemes
@@ -30,27 +43,52 @@ protected:
   vecUtil::Vector2D adrOld;
   vecUtil::Vector3D adrFixed;
   std::map<int,std::pair<std::string,bool>> adrFixedIetFileInfo;
+  // Low-rank representation of the fixed component (one matrix for
+  // each matsubara frequency)
+  std::vector<LowRankMatrix> adrFixedLowRank;
   // Static structure factor (for iterations)
   std::vector<double> ssfNew;
   std::vector<double> ssfOld;
+  // Imaginary frequencies and quadrature weights (ground state only)
+  vecUtil::Vector2D freq;
+  vecUtil::Vector2D freqWeights;
   // Initialize basic properties
   void init();
+  // Construct imaginary frequency grid for ground state calculations
+  void buildFreqGrid();
+  // Compute ideal density response for ground state calculations
+  void computeIdrGround();
   // Compute auxiliary density response
   void computeAdr();
-  void computeAdrFixed();
+  void computeAdrFixed(parallelUtil::MPI::GatherRequest &request);
+  void computeAdrFixedLowRank();
+  std::vector<bool> allocateAdrFixed();
+  void finalizeAdrFixed();
+  void writeAdrFixed() const;
+  std::string getAdrFixedCheckpointPrefix() const;
+  std::vector<std::string> getAdrFixedCheckpointFiles() const;
+  std::vector<bool> readAdrFixedCheckpoints();
+  std::ofstream openAdrFixedCheckpoint(const std::vector<bool> &done) const;
+  void writeAdrFixedCheckpoint(std::ofstream &file,
+			       const int i) const;
+  void removeAdrFixedCheckpoints() const;
   void writeAdrFixedFile(const vecUtil::Vector3D &res,
-			 const std::string &fileName) const;
+			 const std::string &fileName,
+			 const bool iet) const;
+  std::vector<float> getAdrFixedSingle(const vecUtil::Vector3D &res) const;
   int  checkAdrFixed(const std::vector<double> &wvg_,
 		     const double Theta_,
 		     const int nl_) const;
-  void computeAdrIet();
+  void computeAdrIet(vecUtil::Vector2D &adrIet,
+		     parallelUtil::MPI::GatherRequest &request);
   void computeAdrFixedIet();
   void getAdrFixedIetFileInfo();
-  // Compute static structure factor at finite temperature
+  // Compute static structure factor
   void computeSsf();
   void computeSsfFinite();
+  void computeSsfGround();
   // Iterations to solve the stls scheme
-  void doIterations();
+  void doIteration();
   void initialGuess();
   void initialGuessSsf(const std::vector<double> &wvg_,
 		       const std::vector<double> &adr_);
@@ -78,6 +116,10 @@ public:
   void readAdrFixedFile(vecUtil::Vector3D &res,
 			const std::string &fileName,
 			const bool iet) const;
+  void readAdrFixedFile(vecUtil::Vector3D &res,
+			std::vector<LowRankMatrix> &resLowRank,
+			const std::string &fileName,
+			const bool iet) const;
   // Constructor
   Qstls(const QstlsInput &in_,
 	const bool verbose_,
@@ -98,7 +140,7 @@ public:
 
 class Qssf : public Ssf {
 
-private:
+protected:
 
   // Auxiliary density response
   const double *adr;
@@ -123,6 +165,30 @@ public:
  
   
 };
+
+class QssfGround : public Qssf {
+
+private:
+
+  // Quadrature weights for the imaginary frequencies
+  const double *w;
+  
+public:
+
+  // Constructor for zero temperature calculations
+  QssfGround(const double& x_,
+	     const double& rs_,
+	     const double& ssfHF_,
+	     const int& nl_,
+	     const double *idr_,
+	     const double *adr_,
+	     const double *w_)
+    : Qssf(x_, 0, rs_, ssfHF_, nl_, idr_, adr_, 0), w(w_) {;};
+  // Get static structure factor
+  double get() const;
+  
+};
+
 // -----------------------------------------------------------------
 // Classes for the auxiliary density response
 // -----------------------------------------------------------------
@@ -155,7 +221,8 @@ public:
 	  const double& x_,
 	  const Interpolator1D &ssfi_)
     : Theta(Theta_), yMin(yMin_), yMax(yMax_), x(x_),
-      ssfi(ssfi_), isc(-3.0/8.0), isc0(isc*2.0/Theta) {;};
+      ssfi(ssfi_), isc(-3.0/8.0),
+      isc0((Theta > 0.0) ? isc*2.0/Theta : isc) {;};
   
 };
 
@@ -216,6 +283,30 @@ public:
   
 };
 
+// Auxiliary density response for all the wave-vectors from the
+// low-rank representation of the fixed component. The integral of the
+// spline of the fixed component times y (S(y) - 1) is a linear
+// functional of the fixed component (see SplineFunctional), so that it
+// is evaluated once for each right vector of the low-rank
+// representation (the wave-vector of the base class is not used)
+class AdrLowRank : public AdrBase {
+
+public:
+
+  // Constructor for finite temperature calculations
+  AdrLowRank(const double& Theta_,
+	     const double& yMin_,
+	     const double& yMax_,
+	     const Interpolator1D &ssfi_)
+    : AdrBase(Theta_, yMin_, yMax_, 0.0, ssfi_) {;};
+  
+  // Get result of integration
+  void get(const std::vector<double> &wvg,
+	   const std::vector<LowRankMatrix> &fixed,
+	   vecUtil::Vector2D &res);
+  
+};
+
 class AdrFixed : public AdrFixedBase {
   
 private:
@@ -250,7 +341,104 @@ public:
   
 };
 
-// Class for the auxiliary density response calculation in the IET scheme
+// Class for the fixed component at several degeneracy parameters. The
+// fixed components for all the degeneracy parameters are computed in
+// a single pass over the same integration nodes
+class AdrFixedMulti {
+
+private:
+
+  // Degeneracy parameters
+  const std::vector<double> &Theta;
+  // Chemical potentials
+  const std::vector<double> &mu;
+  // Integration limits
+  const double qMin;
+  const double qMax;
+  // Wave-vector
+  const double x;
+  // Integrands (one component for each degeneracy parameter)
+  void integrand1(const double& q,
+		  const int& l,
+		  std::vector<double>& res) const;
+  void integrand2(const double& t,
+		  const double& y,
+		  const int& l,
+		  std::vector<double>& res) const;
+  // Integrator object
+  VectorIntegrator2D &itg;
+  // Grid for 2D integration
+  const std::vector<double> &itgGrid;
+  
+public:
+
+  // Constructor for finite temperature calculations
+  AdrFixedMulti(const std::vector<double>& Theta_,
+		const std::vector<double>& mu_,
+		const double& qMin_,
+		const double& qMax_,
+		const double& x_,
+		const std::vector<double> &itgGrid_,
+		VectorIntegrator2D &itg_)
+    : Theta(Theta_), mu(mu_), qMin(qMin_), qMax(qMax_), x(x_),
+      itg(itg_), itgGrid(itgGrid_) {;};
+  
+  // Get integration result (one tensor for each degeneracy parameter)
+  void get(const std::vector<double> &wvg,
+	   const std::vector<vecUtil::Vector3D*> &res) const;
+  
+};
+
+// Class for the fixed component at zero temperature
+class AdrFixedGround {
+
+private:
+
+  // Wave-vector
+  const double x;
+  // Imaginary frequencies
+  const double *nu;
+  // Integrand
+  double integrand(const double& t,
+		   const double& y,
+		   const double& nu_) const;
+  // Integrator object
+  Integrator1D &itg;
+  
+public:
+
+  // Constructor for zero temperature calculations
+  AdrFixedGround(const double& x_,
+		 const double *nu_,
+		 Integrator1D &itg_)
+    : x(x_), nu(nu_), itg(itg_) {;};
+  
+  // Get integration result
+  void get(std::vector<double> &wvg,
+	   vecUtil::Vector3D &res) const;
+  
+};
+
+// Fixed component of the iet auxiliary density response for one
+// wave-vector. The frequencies that are stored in the files with their
+// low-rank representation are kept in this form
+class AdrFixedIetData {
+
+public:
+
+  // Frequencies stored in full (empty if there are no such frequencies)
+  vecUtil::Vector3D full;
+  // Low-rank representation of each frequency (empty matrices for the
+  // frequencies stored in full)
+  std::vector<LowRankMatrix> lowRank;
+  
+};
+
+// Class for the auxiliary density response calculation in the IET
+// scheme. The bicubic interpolant of a low-rank fixed component is the
+// sum of the products of the splines of the left and right vectors, so
+// that the low-rank representation is used without reconstructing the
+// full matrix
 class AdrIet : public AdrBase {
 
 private:
@@ -272,6 +460,20 @@ private:
   const Interpolator1D &bfi;
   // Interpolator for the fixed component 
   Interpolator2D fixi;
+  // Low-rank representation of the fixed component (nullptr if the
+  // fixed component is stored in full)
+  const LowRankMatrix *fixLowRank;
+  // Interpolators for the left and right vectors of the low-rank
+  // representation
+  std::vector<Interpolator1D> fixiU;
+  std::vector<Interpolator1D> fixiV;
+  // Left vectors at the wave-vector of the last evaluation
+  mutable double fixX;
+  mutable std::vector<double> fixU;
+  // Setup the interpolators for the fixed component
+  void setupFix(const std::vector<double> &wvg,
+		const AdrFixedIetData &fixed,
+		const int& l);
   // Compute dynamic local field correction
   double dlfc(const double& y,
 	      const int& l) const;
@@ -294,11 +496,12 @@ public:
 	 const std::vector<double> &itgGrid_,
 	 Integrator2D &itg_)
     : AdrBase(Theta_, qMin_, qMax_, x_, ssfi_),
-      itg(itg_), itgGrid(itgGrid_), dlfci(dlfci_), bfi(bfi_) {;};
+      itg(itg_), itgGrid(itgGrid_), dlfci(dlfci_), bfi(bfi_),
+      fixLowRank(nullptr) {;};
   
   // Get integration result
   void get(const std::vector<double> &wvg,
-	   const vecUtil::Vector3D &fixed,
+	   const AdrFixedIetData &fixed,
 	   vecUtil::Vector2D &res);
   
 };
@@ -336,5 +539,54 @@ public:
   
 };
 
+// Class to read the fixed component of the iet auxiliary density
+// response on a dedicated thread, ahead of the calculations that use it
+class AdrFixedIetReader {
+
+public:
+
+  // Function used to read the data for one wave-vector
+  using Loader = std::function<void(const int, AdrFixedIetData&)>;
+  
+private:
+
+  // Data read for one wave-vector
+  using Buffer = std::pair<int, std::shared_ptr<AdrFixedIetData>>;
+  // Function used to read the data
+  const Loader loader;
+  // Wave-vector indexes to read
+  const std::vector<int> idx;
+  // Maximum number of buffers that are read but not yet used
+  const size_t capacity;
+  // Buffers that are read but not yet used
+  std::deque<Buffer> buffers;
+  // Number of buffers that were read
+  size_t nRead;
+  // Flag used to stop the reader thread
+  bool stopped;
+  // Error raised by the reader thread
+  std::exception_ptr error;
+  // Synchronization between the reader thread and the consumers
+  std::mutex mtx;
+  std::condition_variable bufferUsed;
+  std::condition_variable bufferRead;
+  std::thread reader;
+  // Read all the data
+  void read();
+  
+public:
+
+  // Constructor (starts the reader thread)
+  AdrFixedIetReader(const Loader& loader_,
+		    const std::vector<int>& idx_,
+		    const size_t capacity_);
+  // Destructor (stops the reader thread)
+  ~AdrFixedIetReader();
+  // Get the next buffer (in the order in which the data is read).
+  // Returns false if all the data was already used
+  bool next(int& i,
+	    std::shared_ptr<AdrFixedIetData>& data);
+  
+};
 
 #endif
@@ -16,10 +16,12 @@ class QStlsCSR : public CSR<vecUtil::Vector2D, Qstls, QVSStlsInput> {
   
 private:
 
-  // Pointer to a location that can be used to copy the fixed component
-  // of the auxiliary density response (if set to nullptr adrFixed is
-  // computed from scratch)
-  vecUtil::Vector3D* adrFixedSource;
+  // Pointer to a state point that can be used to copy the fixed
+  // component of the auxiliary density response (if set to nullptr
+  // adrFixed is computed from scratch)
+  const QStlsCSR* adrFixedSource;
+  // Functional used to compute the Q-adder (computed on first use)
+  mutable SplineFunctional qAdderFunctional;
   // Helper methods to compute the derivatives
   double getDerivative(const std::shared_ptr<vecUtil::Vector2D>& f,
 		       const int &l,
@@ -30,18 +32,30 @@ public:
   
   // Constructor
   QStlsCSR(const QVSStlsInput& in_) : CSR(in_, Qstls(in_, false, false)),
-				      adrFixedSource(nullptr) { ; }
+				      adrFixedSource(nullptr) {
+    // The Q adder is defined only at finite temperature
+    if (in.getDegeneracy() == 0.0) {
+      parallelUtil::MPI::throwError("Ground state calculations are not available "
+				    "for the quantum VS scheme");
+    }
+  }
   // Set the source for the auxiliary density response
-  void setAdrFixedSource(QStlsCSR& other) {
-    adrFixedSource = &(other.adrFixed);
+  void setAdrFixedSource(const QStlsCSR& other) {
+    adrFixedSource = &other;
   }
   // Compute auxiliary density response
   void computeAdrStls();
   void computeAdr();
   // Update the static structure factor
   void updateSsf() { ssf = ssfOld; };
+  // Share the solution with all the MPI ranks
+  void broadcastSolution(const int root);
   // Initialize the scheme
   void init();
+  // Initialize a group of state points that differ only for the
+  // degeneracy parameter. The fixed component of the auxiliary
+  // density response is computed for all the state points at once
+  static void init(const std::vector<QStlsCSR*>& group);
   // Compute Q
   double getQAdder() const;
 
@@ -62,23 +76,17 @@ private:
   const double mu;
   // Integration limits
   const std::pair<double, double> limits;
-  // Grid for 2D integration
-  const std::vector<double> &itgGrid;
-  // Integrator objects
-  Integrator1D& itg1;
-  Integrator2D& itg2;
-  // Interpolator 1D class instance
-  const Interpolator1D& interp;
+  // Integrator object
+  Integrator1D& itg;
   
-  // SSF interpolation
-  double ssf(const double& y) const;
   // Integrands 
   double integrandDenominator(const double q) const;
-  double integrandNumerator1(const double q) const;
-  double integrandNumerator2(const double w) const;
+  double integrandNumerator(const double q,
+			    const double w) const;
   // Get Integral denominator
   void getIntDenominator(double &res) const;
-  
+  // Kernel of the integral over the wave-vector
+  double kernel(const double w) const;
   
 public:
 
@@ -86,15 +94,12 @@ public:
   QAdder(const double& Theta_,
 	 const double& mu_,
 	 double limitMin, double limitMax,
-	 const std::vector<double>& itgGrid_,
-	 Integrator1D& itg1_,
-	 Integrator2D& itg2_,
-	 const Interpolator1D &interp_) :  Theta(Theta_), mu(mu_), 
-					   limits(limitMin, limitMax),
-					   itgGrid(itgGrid_), itg1(itg1_), 
-					   itg2(itg2_), interp(interp_) { ; }
-  // Get Q-adder
-  double get() const;
+	 Integrator1D& itg_) :  Theta(Theta_), mu(mu_), 
+				limits(limitMin, limitMax),
+				itg(itg_) { ; }
+  // Get the functional that gives the Q-adder from ssf - 1 on the
+  // wave-vector grid (the kernel depends only on Theta and mu)
+  SplineFunctional getFunctional(const std::vector<double>& wvg) const;
   
 };
 
@@ -111,6 +116,8 @@ private:
   std::vector<QVSStlsInput> setupCSRInput(const QVSStlsInput& in);
   // Setup dependencies in the CSR objects
   void setupCSRDependencies();
+  // Initialize the state points
+  void init();
   // Perform iterations to compute structural properties
   void doIterations();
   
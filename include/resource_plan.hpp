@@ -0,0 +1,95 @@
+#ifndef RESOURCE_PLAN_HPP
+#define RESOURCE_PLAN_HPP
+
+#include <vector>
+
+// Forward declarations
+class RpaInput;
+class QstlsInput;
+class VSStlsInput;
+class QVSStlsInput;
+
+// -----------------------------------------------------------------
+// Estimate of the resources needed to solve a scheme
+// -----------------------------------------------------------------
+
+// The memory and the disk space are obtained from the size of the
+// largest arrays and files created by the schemes, without solving
+// the schemes. The run time needed to compute the fixed component of
+// the auxiliary density response is extrapolated from the time spent
+// on a sample of the same integrals on the current machine
+class ResourcePlan {
+
+private:
+
+  // Input data
+  const RpaInput in;
+  // Flags for the scheme that is solved
+  bool isQuantum;
+  bool useIet;
+  // Number of state points that are solved simultaneously
+  size_t nStatePoints;
+  // Number of fixed components that are computed (one for each
+  // degeneracy parameter)
+  size_t nFixed;
+  // Flags for the fixed components that are computed from scratch
+  bool computeFixed;
+  bool computeFixedIet;
+  // Size of each element of the files with the fixed component
+  size_t fixedElementSize;
+  // Flag for the low-rank representation of the fixed component
+  bool useLowRank;
+  // Number of OMP threads
+  size_t nThreads;
+  // Number of MPI processes (total and on each node)
+  size_t nRanks;
+  size_t nNodeRanks;
+  // Size of the wave-vector grid
+  size_t nx;
+  // Number of matsubara frequencies
+  size_t nl;
+  // Time needed to compute one integral of the fixed component
+  double itgTime;
+  // Size of the header of the files with the fixed component
+  size_t getFixedHeaderSize() const;
+  // Memory for the arrays of one state point
+  size_t getStatePointMemory() const;
+  // Additional memory needed while the fixed components are computed
+  // and used
+  size_t getFixedMemory() const;
+  size_t getFixedIetMemory() const;
+
+public:
+
+  // Constructors
+  explicit ResourcePlan(const RpaInput &in_);
+  explicit ResourcePlan(const QstlsInput &in_);
+  explicit ResourcePlan(const VSStlsInput &in_);
+  explicit ResourcePlan(const QVSStlsInput &in_);
+  // Set the number of MPI processes (defaults to the processes of
+  // the current calculation)
+  void setRanks(const int nRanks_,
+		const int nNodeRanks_);
+  // Time the integrals of the fixed component for nRows wave-vectors
+  void calibrate(const int nRows);
+  // Size of the wave-vector grid
+  size_t getWaveVectorGridSize() const { return nx; }
+  // Peak memory in bytes
+  size_t getMemoryPerRank() const;
+  size_t getMemoryPerNode() const;
+  // Disk space in bytes
+  size_t getFixedDiskUsage() const;
+  size_t getCheckpointDiskUsage() const;
+  // Number of integrals
+  size_t getIdrIntegrals() const;
+  size_t getFixedIntegrals() const;
+  size_t getFixedIetIntegrals() const;
+  // Run time in seconds for the fixed component (NaN if the plan was
+  // not calibrated)
+  double getFixedRunTime() const;
+  // Print info on screen
+  void print() const;
+
+};
+
+#endif
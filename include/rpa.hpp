@@ -2,6 +2,7 @@
 #define RPA_HPP
 
 #include <vector>
+#include <memory>
 
 // Forward declarations
 namespace vecUtil {
@@ -9,6 +10,7 @@ namespace vecUtil {
 }
 class RpaInput;
 class Integrator1D;
+class GaussLegendre;
 
 // -----------------------------------------------------------------
 // Solver for the Random-Phase approximation scheme
@@ -24,6 +26,12 @@ protected:
   const RpaInput in;
   // Output verbosity
   const bool verbose;
+  // MPI communicator used by the solver
+  const int comm;
+  // Flag marking whether the loops over the wave-vectors of each
+  // iteration are distributed among the MPI ranks (disabled for the
+  // state points of the VS schemes, which are solved on one rank)
+  bool distributed;
   // Name of the recovery files
   std::string recoveryFileName;
   // Integrator
@@ -38,12 +46,12 @@ protected:
   std::vector<double> ssf;
   // Hartree-Fock static structure factor
   std::vector<double> ssfHF;
+  // Plasmon frequencies (used as initial guess at zero temperature)
+  std::vector<double> wp;
   // Chemical potential
   double mu;
   // Initialize basic properties
   void init();
-  // Construct wave vector grid
-  void buildWvGrid();
   // Compute chemical potential
   void computeChemicalPotential();
   // Compute the ideal density response
@@ -67,6 +75,8 @@ public:
   Rpa(const RpaInput& in_) : Rpa(in_, true) { ; }
   // Compute the scheme
   int compute();
+  // Construct the wave vector grid
+  static std::vector<double> buildWvGrid(const RpaInput &in_);
   // Getters
   vecUtil::Vector2D getIdr() const { return idr; }
   std::vector<double> getSlfc() const { return slfc; }
@@ -80,6 +90,31 @@ public:
   
 };
 
+// -----------------------------------------------------------------
+// Process-wide cache for the quantities computed in Rpa::init
+// -----------------------------------------------------------------
+
+class RpaInitCache {
+
+public:
+
+  // Quantities that do not depend on the coupling parameter
+  struct Data {
+    double mu;
+    vecUtil::Vector2D idr;
+    std::vector<double> ssfHF;
+  };
+  // Get the data computed for the same degeneracy parameter, wave-vector
+  // grid, number of Matsubara frequencies and accuracy (nullptr if missing)
+  static std::shared_ptr<const Data> get(const RpaInput &in,
+					 const std::vector<double> &wvg);
+  // Store the data computed for a given input
+  static void add(const RpaInput &in,
+		  const std::vector<double> &wvg,
+		  const Data &data);
+  
+};
+
 // -----------------------------------------------------------------
 // Classes for the ideal density response
 // -----------------------------------------------------------------
@@ -144,6 +179,13 @@ public:
   double im0() const;
   // Get frequency derivative of the real part
   double re0Der() const;
+  // Get result for the imaginary frequency i*Omega (the result is real)
+  double imagFreq0() const;
+  // Get real and imaginary part for a set of frequencies
+  static void get0(const double& x,
+		   const std::vector<double>& Omega,
+		   std::vector<double>& re,
+		   std::vector<double>& im);
   
 };
 
@@ -269,10 +311,23 @@ private:
   const double yMax;
   // Integrator object
   Integrator1D &itg;
+  // Quadrature rule shared among all wave-vectors
+  const GaussLegendre &gl;
+  // Initial guess for the plasmon frequency
+  const double wpGuess;
+  // Plasmon frequency
+  double wp;
   // Integrand for zero temperature calculations
   double integrand(const double& Omega) const ;
+  void integrand(const std::vector<double>& Omega,
+		 std::vector<double>& res) const;
+  // Integral over the particle-hole continuum
+  double integral() const;
   // Plasmon contribution
-  double plasmon() const;
+  double plasmon();
+  // Find an interval that contains the plasmon frequency
+  bool bracketPlasmon(double& wLo,
+		      double& wHi) const;
   // Dielectric response function
   double drf(const double& Omega) const;
   // Frequency derivative of the dielectric response function
@@ -287,10 +342,15 @@ public:
 	    const double& slfc_,
 	    const double& yMin_,
 	    const double& yMax_,
+	    const double& wpGuess_,
+	    const GaussLegendre &gl_,
 	    Integrator1D &itg_) : SsfBase(x_, 0, rs_, ssfHF_, slfc_),
-				  yMin(yMin_), yMax(yMax_), itg(itg_) {;};
+				  yMin(yMin_), yMax(yMax_), itg(itg_), gl(gl_),
+				  wpGuess(wpGuess_), wp(numUtil::NaN) {;};
   // Get result of integration
-  double get() const;
+  double get();
+  // Get plasmon frequency (NaN if there is no plasmon)
+  double getPlasmonFrequency() const { return wp; }
  
   
 };
@@ -2,6 +2,7 @@
 #define STLS_HPP
 
 #include <vector>
+#include <functional>
 #include "rpa.hpp"
 
 // Forward declarations
@@ -16,6 +17,12 @@ class Integrator2D;
 
 class Stls : public Rpa {
 
+public:
+
+  // Function called at the end of each iteration with the iteration
+  // counter and the residual error. Returning false stops the iterations
+  using IterationCallback = std::function<bool(const int, const double)>;
+
 protected: 
 
   // Input parameters
@@ -28,19 +35,33 @@ protected:
   std::vector<double> slfcNew;
   // Bridge function (for iet schemes)
   std::vector<double> bf;
+  // Iteration counter and residual error
+  int counter;
+  double residual;
+  // Accuracy of the integrals used in the last iteration
+  double itgError;
+  // Flag marking that the iterations were stopped by the callback
+  bool stopped;
+  // Callback for the iterations
+  IterationCallback callback;
   // Initialize basic properties
-  void init();
+  virtual void init();
   // Compute static local field correction
   void computeSlfc();
   void computeSlfcStls();
   void computeSlfcIet();
   // Compute bridge function
   void computeBf();
-  // Iterations to solve the stls scheme
+  // Iterations to solve the stls scheme (the initialization and the
+  // single iterations are specialized by the quantum schemes)
   void doIterations();
-  void initialGuess();
+  virtual void doIteration();
+  virtual void initialGuess();
   double computeError() const;
   void updateSolution();
+  bool isIterationDone() const;
+  void callCallback();
+  double getIterationIntError() const;
   // Write recovery files
   void writeRecovery();
   void readRecovery(std::vector<double> &wvgFile,
@@ -55,9 +76,19 @@ public:
   Stls(const StlsInput &in_) : Stls(in_, true, true) { ; };
   // Compute stls scheme
   int compute();
+  // Step-wise solution of the stls scheme
+  int initialize();
+  int step(const int nIter);
+  // Setters
+  void setCallback(const IterationCallback& callback_) { callback = callback_; }
   // Getters
   double getError() const { return computeError(); }
   std::vector<double> getBf() const { return bf; }
+  int getIteration() const { return counter; }
+  double getResidual() const { return residual; }
+  bool isConverged() const {
+    return residual <= in.getErrMin() && itgError <= in.getIntError();
+  }
   
 };
 
@@ -151,12 +182,22 @@ public:
 
 class BridgeFunction {
 
+public:
+
+  // Bridge functions (resolved once from the name of the theory)
+  enum Theory { HNC, IOI, LCT };
+  // Iet mappings (resolved once from the name of the mapping)
+  enum Mapping { STANDARD, SQRT, LINEAR };
+  // Bridge function and iet mapping from their names
+  static Theory getTheory(const std::string& theory);
+  static Mapping getMapping(const std::string& mapping);
+
 private:
 
   // Theory to be solved
-  const std::string theory;
+  const Theory theory;
   // Iet mapping
-  const std::string mapping;
+  const Mapping mapping;
   // Coupling parameter
   const double rs;
   // Degeneracy parameter
@@ -181,8 +222,8 @@ private:
 public:
 
   // Constructor
-  BridgeFunction(const std::string& theory_,
-		 const std::string& mapping_,
+  BridgeFunction(const Theory theory_,
+		 const Mapping mapping_,
 		 const double& rs_,
 		 const double& Theta_,
 		 const double& x_,
@@ -22,6 +22,7 @@ namespace bp = boost::python;
 namespace bn = boost::python::numpy;
 class Interpolator1D;
 class Integrator1D;
+class SplineFunctional;
 
 // -----------------------------------------------------------------
 // Utility functions to handle special cases for double numbers
@@ -75,11 +76,87 @@ namespace vecUtil {
   // Fill vector with constant values
   void fill(std::vector<double> &v,
 	    const double& num);
+
+  // Allocate memory aligned to the cache line size. Blocks larger than
+  // a huge page are aligned to the huge page size and, where available,
+  // backed by transparent huge pages
+  void* allocateAligned(const size_t bytes);
+
+  // Release memory obtained from allocateAligned
+  void freeAligned(void* ptr);
+
+  // --- Allocator for the storage of multidimensional vectors ---
+  template <typename T>
+  class AlignedAllocator {
+  public:
+    using value_type = T;
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) { ; }
+    T* allocate(const size_t n) {
+      return static_cast<T*>(allocateAligned(n * sizeof(T)));
+    }
+    void deallocate(T* ptr, const size_t) { freeAligned(ptr); }
+  };
+
+  template <typename T, typename U>
+  bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return true;
+  }
+
+  template <typename T, typename U>
+  bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) {
+    return false;
+  }
+
+  using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+  // --- Non-owning view of two-dimensional data ---
+  // The element (i, j) is stored at data + i * stride1 + j * stride2,
+  // so that views of the same memory with different layouts (for
+  // instance slices or transposes of multidimensional vectors) can be
+  // passed to the same functions without copies. A view is valid only
+  // as long as the memory that it refers to is valid
+  class MatrixView {
+  private:
+    const double* p;
+    size_t s1;
+    size_t s2;
+    size_t st1;
+    size_t st2;
+  public:
+    MatrixView(const double* p_,
+	       const size_t s1_,
+	       const size_t s2_,
+	       const size_t st1_,
+	       const size_t st2_)
+      : p(p_), s1(s1_), s2(s2_), st1(st1_), st2(st2_) {;};
+    MatrixView(const double* p_,
+	       const size_t s1_,
+	       const size_t s2_)
+      : MatrixView(p_, s1_, s2_, s2_, 1) {;};
+    size_t size() const { return s1*s2; }
+    size_t size(const size_t i) const;
+    const double& operator()(const size_t i,
+			     const size_t j) const { return p[i*st1 + j*st2]; }
+    // First element of a row (only for views with contiguous rows)
+    const double& row(const size_t i) const;
+    // View with rows and columns exchanged
+    MatrixView transpose() const;
+    // View of the rows from i to i + n - 1
+    MatrixView rows(const size_t i,
+		    const size_t n) const;
+    // Layout checks
+    bool hasContiguousRows() const { return st2 == 1 || s2 <= 1; }
+    bool isContiguous() const { return hasContiguousRows() && (st1 == s2 || s1 <= 1); }
+    // Copy the data to a contiguous buffer in row-major order
+    void copyTo(double* out) const;
+  };
   
   // --- Class to represent 2D vectors --- 
   class Vector2D {
   private:
-    std::vector<double> v;
+    AlignedVector v;
     size_t s1;
     size_t s2;
   public:
@@ -99,11 +176,12 @@ namespace vecUtil {
     const double& operator()(const size_t i,
 			     const size_t j) const;
     const double& operator()(const size_t i) const;
+    MatrixView view() const;
     bool operator==(const Vector2D& other) const;
-    std::vector<double>::iterator begin();
-    std::vector<double>::iterator end();
-    std::vector<double>::const_iterator begin() const;
-    std::vector<double>::const_iterator end() const;
+    AlignedVector::iterator begin();
+    AlignedVector::iterator end();
+    AlignedVector::const_iterator begin() const;
+    AlignedVector::const_iterator end() const;
     double* data();
     const double* data() const;
     void fill(const double &num);
@@ -119,12 +197,19 @@ namespace vecUtil {
   };
   
   // --- Class to represent 3D vectors ---
+  // The data can also be stored in memory provided externally (for
+  // instance memory shared among different MPI ranks). Copies of the
+  // vector always own their data, the external storage is used by
+  // other vectors only if they call share
   class Vector3D {
   private:
-    std::vector<double> v;
+    AlignedVector v;
+    std::shared_ptr<double> ext;
     size_t s1;
     size_t s2;
     size_t s3;
+    double* ptr() { return (ext) ? ext.get() : v.data(); }
+    const double* ptr() const { return (ext) ? ext.get() : v.data(); }
   public:
     Vector3D(const size_t s1_,
 	     const size_t s2_,
@@ -132,12 +217,23 @@ namespace vecUtil {
       : v(s1_*s2_*s3_,0.0), s1(s1_), s2(s2_), s3(s3_) {;};
     Vector3D()
       : Vector3D(0, 0, 0) {;};
+    Vector3D(const Vector3D& other);
+    Vector3D(Vector3D&& other) = default;
+    Vector3D& operator=(const Vector3D& other);
+    Vector3D& operator=(Vector3D&& other) = default;
     size_t size() const;
     size_t size(const size_t i) const;
     bool empty() const;
     void resize(const size_t s1_,
 		const size_t s2_,
 		const size_t s3_);
+    void setStorage(const std::shared_ptr<double>& ext_,
+		    const size_t s1_,
+		    const size_t s2_,
+		    const size_t s3_);
+    // Use the external storage of another vector
+    void share(const Vector3D& other);
+    bool hasExternalStorage() const { return ext != nullptr; }
     double& operator()(const size_t i,
 		       const size_t j,
 		       const size_t k);
@@ -147,11 +243,14 @@ namespace vecUtil {
     const double& operator()(const size_t i,
 			     const size_t j) const;
     const double& operator()(const size_t i) const;
+    // Two-dimensional view with the index along dimension dim fixed
+    MatrixView slice(const size_t dim,
+		     const size_t index) const;
     bool operator==(const Vector3D& other) const;
-    std::vector<double>::iterator begin();
-    std::vector<double>::iterator end();
-    std::vector<double>::const_iterator begin() const;
-    std::vector<double>::const_iterator end() const;
+    double* begin();
+    double* end();
+    const double* begin() const;
+    const double* end() const;
     double* data();
     const double* data() const;
     void fill(const double &num);
@@ -237,17 +336,8 @@ namespace thermoUtil {
 
     // Coupling parameter
     const double rs;
-    // Integration limits
-    const double yMin;
-    const double yMax;
-    // Integrator object
-    Integrator1D &itg;
-    // Static structure factor interpolator
-    const Interpolator1D &ssfi;
-    // Integrand
-    double integrand(const double& y) const ;
-    // Compute static structure factor
-    double ssf(const double& y) const;
+    // Functional that gives the integral of ssf - 1
+    std::shared_ptr<const SplineFunctional> functional;
     // Constant for unit conversion
     const double lambda = pow(4.0/(9.0*M_PI), 1.0/3.0);
   
@@ -255,13 +345,9 @@ namespace thermoUtil {
 
     // Constructor
     InternalEnergy(const double& rs_,
-		   const double& yMin_,
-		   const double& yMax_,
-		   const Interpolator1D &ssfi_,
-		   Integrator1D &itg_) : rs(rs_), yMin(yMin_), yMax(yMax_),
-					 itg(itg_), ssfi(ssfi_) {;};
+		   const std::vector<double> &wvg_);
     // Get result of integration 
-    double get() const;
+    double get(const std::vector<double> &ssf) const;
   
   };
 
@@ -300,32 +386,16 @@ namespace thermoUtil {
     
   private:
 
-    // Spatial position
-    const double r;
-    // Cutoff in the wave-vector grid
-    const double cutoff;
-    // Fourier Integrator object
-    Integrator1D& itgf;
-    // Integrator object
-    Integrator1D& itg;
-    // Static structure factor interpolator
-    const Interpolator1D& ssfi;
-    // Integrand
-    double integrand(const double& y) const;
-    // Compute static structure factor
-    double ssf(const double& y) const ;
+    // Functional that gives the Fourier transform of ssf - 1
+    std::shared_ptr<const SplineFunctional> functional;
   
   public:
 
     // Constructor
-    Rdf(const double& r_,
-	const double& cutoff_,
-	const Interpolator1D& ssfi_,
-        Integrator1D& itg_,
-	Integrator1D& itgf_) : r(r_), cutoff(cutoff_),
-			       itgf(itgf_), itg(itg_), ssfi(ssfi_) {;};
+    Rdf(const double& r,
+	const std::vector<double> &wvg_);
     // Get result of integration 
-    double get() const;
+    double get(const std::vector<double> &ssf) const;
   
   };
   
@@ -347,6 +417,11 @@ namespace binUtil {
     writeNum<double>(file, data);
   };
   
+  template<typename T>
+  void writeDataToBinary(std::ofstream &file, const float &data) {
+    writeNum<float>(file, data);
+  };
+  
   template<typename T>
   void writeDataToBinary(std::ofstream &file, const int &data) {
     writeNum<int>(file, data);
@@ -367,6 +442,11 @@ namespace binUtil {
     readNum<double>(file, data);
   };
   
+  template<typename T>
+  void readDataFromBinary(std::ifstream &file, float &data) {
+    readNum<float>(file, data);
+  };
+  
   template<typename T>
   void readDataFromBinary(std::ifstream &file, int &data) {
     readNum<int>(file, data);
@@ -423,6 +503,106 @@ namespace parallelUtil {
 
     // Check that a number is the same on all ranks
     bool isEqualOnAllRanks(const int& myNumber);
+
+    // Split the ranks of the active communicator in groups with the
+    // same color. Returns the identifier of the communicator for the
+    // group of the calling rank
+    int splitCommunicator(const int color);
+
+    // Free a communicator obtained from splitCommunicator. Must be
+    // called by all the ranks of the communicator. The communicator
+    // must not be active and the memory allocated with allocateShared
+    // on the communicator must no longer be used
+    void freeCommunicator(const int commId);
+
+    // Get the rank, in the communicator with all the ranks, of the root
+    // of the active communicator. Different groups of ranks obtained
+    // from splitCommunicator have different roots
+    int groupRoot();
+
+    // Get the identifier of the active communicator (the communicator
+    // with all the ranks has identifier 0)
+    int getCommunicator();
+
+    // Set the communicator used by all the MPI calls
+    void setCommunicator(const int commId);
+
+    // Activate a communicator until the end of the current scope
+    class CommunicatorScope {
+    public:
+      CommunicatorScope(const int commId);
+      ~CommunicatorScope();
+      CommunicatorScope(const CommunicatorScope&) = delete;
+      CommunicatorScope& operator=(const CommunicatorScope&) = delete;
+    private:
+      const int previous;
+    };
+
+    // Mark the work done by the calling thread until the end of the
+    // current scope as local to the rank. The calls that communicate
+    // among the ranks are not allowed inside this scope
+    class LocalScope {
+    public:
+      LocalScope();
+      ~LocalScope();
+      LocalScope(const LocalScope&) = delete;
+      LocalScope& operator=(const LocalScope&) = delete;
+    };
+
+    // Get rank of MPI process among the ranks on the same node
+    int nodeRank();
+
+    // Get number of MPI processes on the same node
+    int numberOfNodeRanks();
+
+    // Check if the process is the leader of the ranks on its node
+    bool isNodeLeader();
+
+    // Set an MPI Barrier among the ranks on the same node
+    void nodeBarrier();
+
+    // Allocate memory for n doubles shared among the ranks on the same
+    // node. The memory is initialized to zero. When the last copy of
+    // the returned pointer is destroyed, the memory is marked as
+    // unused. It is released by the next allocation on the same
+    // communicator (or by finalize) if it is unused on all the ranks
+    std::shared_ptr<double> allocateShared(const size_t n);
+
+    // Allocate memory shared among the ranks on the same node to store
+    // the data of a parallel for loop with loopSize iterations. The
+    // memory of each iteration is initialized to zero by the rank and
+    // by the thread that run the iteration in parallelFor
+    std::shared_ptr<double> allocateShared(const size_t n,
+					   const int loopSize,
+					   const int ompThreads);
+
+    // Make the data written to memory obtained from allocateShared
+    // visible to all the ranks on the same node
+    void syncShared(const double* data);
+  
+    // Broadcast data from the root rank to all the other ranks
+    void broadcast(double* data,
+		   const int count,
+		   const int root);
+    void broadcast(int* data,
+		   const int count,
+		   const int root);
+
+    // Buffer exchanged with another rank in a point-to-point communication
+    struct Message {
+      // Data to send or receive
+      double* data;
+      int count;
+      // Destination (for sends) or source (for receives)
+      int rank;
+      // Tag used to match sends and receives
+      int tag;
+    };
+
+    // Send and receive a set of messages. Returns when all the
+    // communications are completed
+    void exchangeMessages(const std::vector<Message>& toSend,
+			  const std::vector<Message>& toRecv);
   
     // Data structure to track how loop indexes are distributed
     using MPIParallelForData = std::vector<std::pair<int, int>>;
@@ -434,15 +614,45 @@ namespace parallelUtil {
     // Get start and finish index for parallel for loop on all ranks
     MPIParallelForData getAllLoopIndexes(const int loopSize);
 
-    // Wrapper for parallel for loop
+    // Wrapper for parallel for loop. If progressInterval is larger
+    // than zero, the root rank prints the progress of the loop and an
+    // estimate of the remaining time every progressInterval seconds
     MPIParallelForData parallelFor(const std::function<void(int)>& loopFunc,
 				   const int loopSize,
-				   const int ompThreads);
+				   const int ompThreads,
+				   const std::string& progressLabel = "",
+				   const double progressInterval = 0.0);
     
-    // Synchronize data from a parallel for loop among all ranks
+    // Synchronize data from a parallel for loop among all ranks. If
+    // the data is stored in memory obtained from allocateShared, the
+    // data is exchanged only among the leaders of each node
     void gatherLoopData(double* dataToGather,
 			const MPIParallelForData& loopData,
 			const int countsPerLoop);
+
+    // Handle to a non-blocking gather of the data from a parallel
+    // for loop. The data must not be accessed until wait() returns
+    class GatherRequest {
+    public:
+      class Impl;
+      GatherRequest();
+      GatherRequest(std::unique_ptr<Impl> impl_);
+      GatherRequest(GatherRequest&& other);
+      GatherRequest& operator=(GatherRequest&& other);
+      // The destructor waits for the communication to complete
+      ~GatherRequest();
+      // Wait for the communication to complete
+      void wait();
+      // Check if the communication is complete
+      bool test();
+    private:
+      std::unique_ptr<Impl> impl;
+    };
+
+    // Non-blocking version of gatherLoopData
+    GatherRequest gatherLoopDataAsync(double* dataToGather,
+				      const MPIParallelForData& loopData,
+				      const int countsPerLoop);
     
   }
   
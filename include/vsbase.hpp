@@ -3,6 +3,7 @@
 
 #include <limits>
 #include <map>
+#include <set>
 
 // Forward declarations
 class VSStlsInput;
@@ -32,14 +33,88 @@ protected:
   
   // Iterations to solve the vs scheme
   void doIterations() {
-    auto func = [this](const double& alphaTmp)->double{return alphaDifference(alphaTmp);};
+    std::vector<double> guess = in.getAlphaGuess();
+    std::map<double, double> known;
+    if (std::min(in.getAlphaGroups(), parallelUtil::MPI::numberOfRanks()) > 1) {
+      known = bracketAlpha(guess);
+    }
+    double lastAlpha = numUtil::NaN;
+    bool lastKnown = false;
+    auto func = [&](const double& alphaTmp)->double{
+      const auto it = known.find(alphaTmp);
+      lastAlpha = alphaTmp;
+      lastKnown = it != known.end();
+      return (lastKnown) ? it->second : alphaDifference(alphaTmp);
+    };
     SecantSolver rsol(in.getErrMinAlpha(), in.getNIterAlpha());
-    rsol.solve(func, in.getAlphaGuess());
+    rsol.solve(func, guess);
+    // The solution is taken from the last point computed by the solver
+    if (lastKnown) { alphaDifference(lastAlpha); }
     alpha = rsol.getSolution();
     if (verbose) { std::cout << "Free parameter = " << alpha << std::endl; }
     updateSolution();
   }
 
+  // Tabulate the object function concurrently on groups of MPI ranks
+  // to restrict the interval used as guess for the secant solver. The
+  // first point is computed with all the ranks, so that the
+  // initialization and the recursive calculations for smaller coupling
+  // parameters are shared. Returns the end points of the restricted
+  // interval together with the values of the object function
+  std::map<double, double> bracketAlpha(std::vector<double>& guess) {
+    namespace MPI = parallelUtil::MPI;
+    const int nRanks = MPI::numberOfRanks();
+    const int nGroups = std::min(in.getAlphaGroups(), nRanks);
+    const int thisGroup = MPI::rank() * nGroups / nRanks;
+    // Candidates for the free parameter
+    const double dAlpha = (guess[1] - guess[0]) / nGroups;
+    std::vector<double> alphaGrid(nGroups + 1);
+    for (int k = 0; k <= nGroups; ++k) {
+      alphaGrid[k] = guess[0] + k * dAlpha;
+    }
+    alphaGrid.back() = guess[1];
+    std::vector<double> diffGrid(nGroups + 1);
+    diffGrid[0] = alphaDifference(alphaGrid[0]);
+    const int groupComm = MPI::splitCommunicator(thisGroup);
+    {
+      MPI::CommunicatorScope groupScope(groupComm);
+      diffGrid[thisGroup + 1] = alphaDifference(alphaGrid[thisGroup + 1]);
+    }
+    // The solvers created by the group are destroyed at this point
+    MPI::freeCommunicator(groupComm);
+    // Share the candidates computed by each group with all the ranks
+    for (int k = 0; k < nGroups; ++k) {
+      const int root = (k * nRanks + nGroups - 1) / nGroups;
+      MPI::broadcast(&diffGrid[k + 1], 1, root);
+    }
+    // Restrict the guess to the first interval where the object
+    // function changes sign or, if there is no such interval, to the
+    // candidate with the smallest object function and its best neighbour
+    const size_t n = diffGrid.size();
+    size_t i0 = n;
+    for (size_t k = 0; k < n - 1 && i0 == n; ++k) {
+      if (diffGrid[k] * diffGrid[k + 1] <= 0.0) { i0 = k; }
+    }
+    size_t i1 = i0 + 1;
+    if (i0 == n) {
+      auto absLess = [](const double& a, const double& b) {
+	return std::abs(a) < std::abs(b);
+      };
+      i1 = std::distance(diffGrid.begin(),
+			 std::min_element(diffGrid.begin(), diffGrid.end(), absLess));
+      if (i1 == 0) { i0 = 1; }
+      else if (i1 == n - 1) { i0 = n - 2; }
+      else { i0 = absLess(diffGrid[i1 - 1], diffGrid[i1 + 1]) ? i1 - 1 : i1 + 1; }
+    }
+    if (verbose) {
+      std::cout << "Free parameter restricted to the interval ["
+		<< alphaGrid[std::min(i0, i1)] << ","
+		<< alphaGrid[std::max(i0, i1)] << "]" << std::endl;
+    }
+    guess = {alphaGrid[i0], alphaGrid[i1]};
+    return {{alphaGrid[i0], diffGrid[i0]}, {alphaGrid[i1], diffGrid[i1]}};
+  }
+
   // Object function used in the secant solver
   double alphaDifference(const double& alphaTmp) {
     alpha = alphaTmp;
@@ -71,6 +146,7 @@ public:
   
   // Compute vs-stls scheme
   int compute() {
+    parallelUtil::MPI::CommunicatorScope commScope(Scheme::comm);
     try {
       Scheme::init();
       if (verbose) std::cout << "Free parameter calculation ..." << std::endl;
@@ -88,6 +164,10 @@ public:
   const ThermoProp& getThermoProp() const {
     return thermoProp;
   }
+
+  double getAlpha() const {
+    return alpha;
+  }
   
   std::vector<std::vector<double>> getFreeEnergyIntegrand() const {
     return thermoProp.getFreeEnergyIntegrand();
@@ -122,6 +202,13 @@ protected:
   StructProp structProp;
   // Grid for thermodyamic integration
   std::vector<double> rsGrid;
+  // Coupling parameters of the recursive calculations used to fill
+  // the free energy integrand
+  std::vector<double> rsNodes;
+  // Coupling parameter of the central state point
+  double rsCenter;
+  // Resolution of the coupling parameter grid for the derivatives
+  double drs;
   // Free energy integrand for NPOINTS state points
   std::vector<std::vector<double>> fxcIntegrand;
   // Flags marking particular state points
@@ -146,23 +233,88 @@ protected:
     const std::vector<double>& rs = structProp.getCouplingParameters();
     return thermoUtil::computeFreeEnergy(rsGrid, fxcIntegrand[iThermo], rs[iStruct], normalize);
   }
+
+  // Setup the grid for the thermodynamic integration. The free energy
+  // integrand is obtained for three coupling parameters spaced by drs
+  // from each calculation, hence the grid is the union of groups of
+  // three points centered on the nodes of the recursive calculations
+  // and on the central state point. The nodes are spaced by the
+  // resolution for the free energy (by default two times drs, which
+  // gives a uniform grid with spacing drs if the coupling parameter is
+  // a multiple of drs). The points that are closer than drs/2 to a point
+  // of the grid are skipped, giving precedence to rs = 0 and to the
+  // central state point, so that the grid is sorted and free of nearly
+  // coincident points
+  void setupGrid(const Input &in) {
+    const double dNode = std::max(in.getFreeEnergyCouplingResolution(), 2.0 * drs);
+    rsCenter = std::max(in.getCoupling(), drs);
+    rsGrid.assign(1, 0.0);
+    rsNodes.clear();
+    auto addGroup = [&](const double& rs) {
+      for (const double& rsTmp : {rs - drs, rs, rs + drs}) {
+	bool isFar = true;
+	for (const double& rsGridTmp : rsGrid) {
+	  isFar = isFar && std::abs(rsGridTmp - rsTmp) >= 0.5 * drs;
+	}
+	if (isFar) { rsGrid.push_back(rsTmp); }
+      }
+    };
+    addGroup(rsCenter);
+    for (int k = 0; ; ++k) {
+      const double rsNode = drs + k * dNode;
+      // The first node is always needed to obtain the integrand at rs = 0
+      const bool firstNode = k == 0 && numUtil::largerThan(rsCenter, drs);
+      if (!firstNode && numUtil::largerThan(rsNode + drs, rsCenter - drs)) { break; }
+      rsNodes.push_back(rsNode);
+      addGroup(rsNode);
+    }
+    std::sort(rsGrid.begin(), rsGrid.end());
+  }
+
+  // Index of a point in the grid for the thermodynamic integration
+  // (the size of the grid is returned if the point is not found)
+  size_t getGridIndex(const double& rs) const {
+    for (size_t i = 0; i < rsGrid.size(); ++i) {
+      if (rsGrid[i] == rs || numUtil::equalTol(rsGrid[i], rs)) { return i; }
+    }
+    return rsGrid.size();
+  }
+
+  // Check if the free energy integrand is available for all the
+  // points of the group centered on rs
+  bool isIntegrandAvailable(const double& rs) const {
+    for (const double& rsTmp : {rs - drs, rs, rs + drs}) {
+      const size_t i = getGridIndex(rsTmp);
+      if (i < rsGrid.size() && fxcIntegrand[THETA][i] == numUtil::Inf) {
+	return false;
+      }
+    }
+    return true;
+  }
+
+  // Store the free energy integrand of the state points centered on rs
+  void setIntegrand(const double& rs,
+		    const std::vector<double>& fxci) {
+    for (const auto& theta : {Idx::THETA_DOWN, Idx::THETA, Idx::THETA_UP}) {
+      for (int j = 0; j < StructProp::NRS; ++j) {
+	const size_t i = getGridIndex(rs + (j - 1) * drs);
+	if (i == rsGrid.size()) { continue; }
+	fxcIntegrand[theta][i] = fxci[theta * StructProp::NRS + j];
+      }
+    }
+  }
   
 public:
 
   // Constructors
   ThermoPropBase(const Input &in) : verbose(parallelUtil::MPI::isRoot()),
 				    structProp(in) {
-    const double& rs = in.getCoupling();
-    const double& drs = in.getCouplingResolution();
+    drs = in.getCouplingResolution();
     // Check if we are solving for particular state points
-    isZeroCoupling = (rs == 0.0);
+    isZeroCoupling = (in.getCoupling() == 0.0);
     isZeroDegeneracy = (in.getDegeneracy() == 0.0);
     // Build integration grid
-    rsGrid.push_back(0.0);
-    const double rsMax = rs + drs;
-    while(!numUtil::equalTol(rsGrid.back(), rsMax)){
-      rsGrid. push_back(rsGrid.back() + drs);
-    }
+    setupGrid(in);
     // Initialize the free energy integrand
     fxcIntegrand.resize(NPOINTS);
     const size_t nrs = rsGrid.size();
@@ -186,17 +338,14 @@ public:
   
   ThermoPropBase(const Input &in,
 		 const ThermoPropBase &other) : ThermoPropBase(in) {
-    assert(other.rsGrid[1] - other.rsGrid[0] == rsGrid[1] - rsGrid[0]);
     const size_t nrs = rsGrid.size();
-    const double rsMax = other.rsGrid.back();
     for (const auto& theta : {Idx::THETA_DOWN, Idx::THETA, Idx::THETA_UP}) {
-      const auto& fxciBegin = fxcIntegrand[theta].begin();
-      const auto& fxciEnd = fxcIntegrand[theta].end();
-      const auto& it = std::find(fxciBegin, fxciEnd, numUtil::Inf);
-      size_t i =  std::distance(fxciBegin, it);
-      while (i < nrs && rsGrid[i] < rsMax) {
-	fxcIntegrand[theta][i] = other.fxcIntegrand[theta][i];
-	++i;
+      for (size_t i = 0; i < nrs; ++i) {
+	if (fxcIntegrand[theta][i] != numUtil::Inf) { continue; }
+	const size_t j = other.getGridIndex(rsGrid[i]);
+	if (j < other.rsGrid.size()) {
+	  fxcIntegrand[theta][i] = other.fxcIntegrand[theta][j];
+	}
       }
     }
   }
@@ -211,45 +360,26 @@ public:
   void compute(const Input &in) {
     // Recursive calls to solve the VS-STLS scheme for all state points
     // with coupling parameter smaller than rs
-    const double nrs = rsGrid.size();
     Input inTmp = in;
-    std::vector<double> fxciTmp(StructProp::NPOINTS);
-    for (size_t i = 0; i < nrs; ++i) {
-      const double& rs = rsGrid[i];
-      if (numUtil::equalTol(rs, in.getCoupling())) {
-	structProp.compute();
-	fxciTmp = structProp.getFreeEnergyIntegrand();
-      }
-      else if (rs < in.getCoupling()) {
-	if (rs == 0.0 || fxcIntegrand[THETA][i] != numUtil::Inf) { continue; }
-	if (verbose) {
-	  printf("Free energy integrand calculation, "
-		 "solving VS scheme for rs = %.5f:\n", rs);
-	}
-	inTmp.setCoupling(rs);
-	Scheme schemeTmp(inTmp, *this);
-	schemeTmp.compute();
-	fxciTmp = schemeTmp.getThermoProp().structProp.getFreeEnergyIntegrand();
-	if (verbose) {
-	  printf("Done\n");
-	  printf("---------------------------------"
-		 "---------------------------------"
-		 "---------\n");
-	}
+    for (const double& rsNode : rsNodes) {
+      if (isIntegrandAvailable(rsNode)) { continue; }
+      if (verbose) {
+	printf("Free energy integrand calculation, "
+	       "solving VS scheme for rs = %.5f:\n", rsNode);
       }
-      else {
-	break;
+      inTmp.setCoupling(rsNode);
+      Scheme schemeTmp(inTmp, *this);
+      schemeTmp.compute();
+      setIntegrand(rsNode, schemeTmp.getThermoProp().structProp.getFreeEnergyIntegrand());
+      if (verbose) {
+	printf("Done\n");
+	printf("---------------------------------"
+	       "---------------------------------"
+	       "---------\n");
       }
-      fxcIntegrand[THETA_DOWN][i-1] = fxciTmp[SIdx::RS_DOWN_THETA_DOWN];
-      fxcIntegrand[THETA_DOWN][i]   = fxciTmp[SIdx::RS_THETA_DOWN];
-      fxcIntegrand[THETA_DOWN][i+1] = fxciTmp[SIdx::RS_UP_THETA_DOWN];
-      fxcIntegrand[THETA][i-1]      = fxciTmp[SIdx::RS_DOWN_THETA];
-      fxcIntegrand[THETA][i]        = fxciTmp[SIdx::RS_THETA];
-      fxcIntegrand[THETA][i+1]      = fxciTmp[SIdx::RS_UP_THETA];
-      fxcIntegrand[THETA_UP][i-1]   = fxciTmp[SIdx::RS_DOWN_THETA_UP];
-      fxcIntegrand[THETA_UP][i]     = fxciTmp[SIdx::RS_THETA_UP];
-      fxcIntegrand[THETA_UP][i+1]   = fxciTmp[SIdx::RS_UP_THETA_UP];
     }
+    structProp.compute();
+    setIntegrand(rsCenter, structProp.getFreeEnergyIntegrand());
   }
 
   // Get structural properties
@@ -272,6 +402,10 @@ public:
   std::vector<double> getFreeEnergyData() const {
     const std::vector<double> rsVec = structProp.getCouplingParameters();
     const std::vector<double> thetaVec = structProp.getDegeneracyParameters();
+    // The derivative of the free energy with respect to the coupling
+    // parameter is the free energy integrand, hence the first order
+    // derivatives in rs are taken directly from the integrand
+    const std::vector<double> fxci = structProp.getFreeEnergyIntegrand();
     // Free energy
     const double fxc = computeFreeEnergy(SIdx::RS_THETA, true);
     // Free energy derivatives with respect to the coupling parameter
@@ -283,7 +417,7 @@ public:
       const double f0 = computeFreeEnergy(SIdx::RS_UP_THETA, false);
       const double f1 = computeFreeEnergy(SIdx::RS_THETA, false);
       const double f2 = computeFreeEnergy(SIdx::RS_DOWN_THETA, false);
-      fxcr = (f0 - f2) / (2.0 * drs * rs) - 2.0 * fxc;
+      fxcr = fxci[SIdx::RS_THETA] / rs - 2.0 * fxc;
       fxcrr = (f0 - 2.0 * f1 + f2) / (drs * drs) - 2.0 * fxc - 4.0 * fxcr;
     }
     // Free energy derivatives with respect to the degeneracy parameter
@@ -302,13 +436,10 @@ public:
     double fxcrt;
     {
       const double t_rs = thetaVec[SIdx::RS_THETA] / rsVec[SIdx::RS_THETA];
-      const double drs = rsVec[SIdx::RS_UP_THETA] - rsVec[SIdx::RS_THETA];
       const double dt = thetaVec[SIdx::RS_THETA_UP] - thetaVec[SIdx::RS_THETA];
-      const double f0 = computeFreeEnergy(SIdx::RS_UP_THETA_UP, false);
-      const double f1 = computeFreeEnergy(SIdx::RS_UP_THETA_DOWN, false);
-      const double f2 = computeFreeEnergy(SIdx::RS_DOWN_THETA_UP, false);
-      const double f3 = computeFreeEnergy(SIdx::RS_DOWN_THETA_DOWN, false);
-      fxcrt = t_rs * (f0 - f1 - f2 + f3) / (4.0 * drs * dt) - 2.0 * fxct;
+      const double& f0 = fxci[SIdx::RS_THETA_UP];
+      const double& f1 = fxci[SIdx::RS_THETA_DOWN];
+      fxcrt = t_rs * (f0 - f1) / (2.0 * dt) - 2.0 * fxct;
     }
     return std::vector<double>({fxc, fxcr, fxcrr, fxct, fxctt, fxcrt});
   }
@@ -388,6 +519,10 @@ protected:
   bool computed;
   // Vector used as output parameter in the getters functions
   mutable std::vector<double> outVector;
+  // MPI rank that solves each state point
+  std::vector<int> csrOwner;
+  // Indexes of the state points solved by this rank
+  std::vector<size_t> localCsr;
 
   // Setup input for the CSR objects
   std::vector<Input> setupCSRInput(const Input& in) {
@@ -448,6 +583,72 @@ protected:
     assert(csr.size() == NPOINTS);
   }
   
+  // Distribute the state points among the MPI ranks
+  void setupCSROwners() {
+    const auto loopData = parallelUtil::MPI::getAllLoopIndexes(NPOINTS);
+    const int thisRank = parallelUtil::MPI::rank();
+    csrOwner.assign(NPOINTS, 0);
+    localCsr.clear();
+    for (size_t r = 0; r < loopData.size(); ++r) {
+      for (int i = loopData[r].first; i < loopData[r].second; ++i) {
+	csrOwner[i] = r;
+	if (static_cast<int>(r) == thisRank) { localCsr.push_back(i); }
+      }
+    }
+  }
+
+  // Exchange the local field corrections needed to compute the
+  // derivatives of the state points solved on different ranks
+  void exchangeLfc() {
+    if (parallelUtil::MPI::isSingleProcess()) { return; }
+    using Message = parallelUtil::MPI::Message;
+    const int thisRank = parallelUtil::MPI::rank();
+    std::vector<Message> toSend;
+    std::vector<Message> toRecv;
+    for (size_t j = 0; j < NPOINTS; ++j) {
+      std::set<int> dest;
+      for (size_t i = 0; i < NPOINTS; ++i) {
+	if (csr[i].dependsOn(csr[j])) { dest.insert(csrOwner[i]); }
+      }
+      if (csrOwner[j] == thisRank) {
+	dest.erase(thisRank);
+	for (const int& r : dest) {
+	  auto& lfc = csr[j].getLfc();
+	  toSend.push_back(Message{lfc.data(), static_cast<int>(lfc.size()), r,
+				   static_cast<int>(j)});
+	}
+      }
+      else if (dest.count(thisRank) > 0) {
+	// The remote data has the same size as the data of the local
+	// state points
+	auto& lfc = csr[j].getLfc();
+	lfc = csr[localCsr.front()].getLfc();
+	toRecv.push_back(Message{lfc.data(), static_cast<int>(lfc.size()),
+				 csrOwner[j], static_cast<int>(j)});
+      }
+    }
+    parallelUtil::MPI::exchangeMessages(toSend, toRecv);
+  }
+
+  // Share the solution of each state point with all the ranks
+  void broadcastSolution() {
+    if (parallelUtil::MPI::isSingleProcess()) { return; }
+    for (size_t i = 0; i < NPOINTS; ++i) {
+      csr[i].broadcastSolution(csrOwner[i]);
+    }
+  }
+
+  // Share the residual error of the central state point with all the ranks
+  void broadcastError(double& err) {
+    if (parallelUtil::MPI::isSingleProcess()) { return; }
+    parallelUtil::MPI::broadcast(&err, 1, csrOwner[RS_THETA]);
+  }
+  
+  // Initialize the state points
+  virtual void init() {
+    for (auto& c : csr) { c.init(); }
+  }
+  
   // Perform iterations to compute structural properties
   virtual void doIterations() = 0;
 
@@ -476,9 +677,12 @@ public:
   int compute() {
     try {
       if (!csrIsInitialized) {
-	for (auto& c : csr) { c.init(); }
+	init();
 	csrIsInitialized = true;
       }
+      // The state points are distributed among the ranks of the active
+      // communicator, which can change between successive calls
+      setupCSROwners();
       doIterations();
       computed = true;
       return 0;
@@ -583,7 +787,10 @@ public:
       const Scheme& scheme) : Scheme(scheme),
 			      in(in_),
 			      lfc(std::make_shared<T>()),
-			      alpha(DEFAULT_ALPHA) { ; }
+			      alpha(DEFAULT_ALPHA) {
+    // The iterations of each state point run on a single rank
+    Scheme::distributed = false;
+  }
 
   // Set the data to compute the coupling parameter derivative
   void setDrsData(CSR<T, Scheme, Input> &csrRsUp,
@@ -599,6 +806,16 @@ public:
     lfcTheta = DerivativeData{dTypeTheta, csrThetaUp.lfc, csrThetaDown.lfc};
   }
 
+  // Check if the derivatives depend on the local field correction
+  // of another state point
+  bool dependsOn(const CSR<T, Scheme, Input> &other) const {
+    return lfcRs.up == other.lfc || lfcRs.down == other.lfc
+      || lfcTheta.up == other.lfc || lfcTheta.down == other.lfc;
+  }
+
+  // Local field correction (exchanged among the MPI ranks)
+  T& getLfc() { return *lfc; }
+  
   // Publicly esposed private scheme methods
   void init() { Scheme::init(); }
   void initialGuess() { Scheme::initialGuess(); }
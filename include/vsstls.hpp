@@ -29,6 +29,8 @@ public:
   // Compute static local field correction
   void computeSlfcStls();
   void computeSlfc();
+  // Share the solution with all the MPI ranks
+  void broadcastSolution(const int root);
   
 };
 
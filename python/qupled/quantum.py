@@ -32,7 +32,7 @@ class Qstls(qc.Stls):
         mixing: Mixing parameter for iterative solution, defaults to 1.0.  
         guess:  Initial guess for the iterative solution, defaults to None, i.e. ssf from stls solution.
         iterations: Maximum number of iterations, defaults to 1000.
-        matsubara: Number of matsubara frequencies, defaults to 128.
+        matsubara: Number of matsubara frequencies (number of imaginary frequencies in the ground state), defaults to 128.
         outputFrequency: Frequency used to print the recovery files, defaults to 10.
         recoveryFile: Name of the recovery file used to restart the simulation, defualts to None.
         resolution: Resolution of the wave-vector grid, defaults to 0.1.
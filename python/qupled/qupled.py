@@ -44,6 +44,12 @@ class StlsInput(RpaInput):
     def __init__(self):
         self.error : float = None
         """ minimum error for convergence """
+        self.errorIntegralsScaling : float = None
+        """ ratio between the accuracy of the integrals and the residual error
+        of the iterations. If larger than zero the integrals are solved with
+        accuracy max(accuracy, errorIntegralsScaling * residual) so that the first
+        iterations are cheaper, while the last iterations always use the input
+        accuracy """
         self.mixing : float = None
         """ mixing paramter """
         self.iet : str = None
@@ -87,10 +93,29 @@ class VSStlsInput(StlsInput):
         """ Resolution of the coupling parameter grid """
         self.degeneracyResolution : float = None
         """ Resolution of the degeneracy parameter grid """
+        self.freeEnergyCouplingResolution : float = None
+        """ Resolution of the coupling parameter grid used to integrate the free
+	energy. The free energy integrand is computed by solving the VS scheme at
+	coupling parameters spaced by this resolution. Each solution provides the
+	integrand at three points spaced by couplingResolution. Values smaller than
+	two times couplingResolution (including the default, zero) give a uniform
+	grid with spacing couplingResolution. Larger values reduce the number of
+	recursive calculations, and hence the cost of the free energy, roughly in
+	proportion to the resolution, but the integrand is interpolated over larger
+	gaps: the error of the free energy and of its derivatives with respect to
+	the coupling parameter grows accordingly, which affects the free parameter
+	of the VS schemes. Points of the grid closer than couplingResolution/2 to
+	another point are skipped """
         self.errorAlpha : float = None
         """ Minimum error for convergence in the free parameter """
         self.iterationsAlpha : int = None
         """ Maximum number of iterations to determine the free parameter """
+        self.groupsAlpha : int = None
+        """ Number of groups of MPI processes used to determine the free parameter.
+	If larger than one, the processes are split in groups that compute the
+	free parameter concurrently for different candidates. The candidates
+	are used to restrict the initial guess of the free parameter before the
+	secant iterations, that are then performed with all the processes """
         self.freeEnergyIntegrand : qupled.FreeEnergyIntegrand = None
         """ Pre-computed free energy integrand """
 
@@ -109,6 +134,33 @@ class QstlsInput(StlsInput):
         """ name of the zip file storing the fixed components of the auxiliary density
 	response in the QSTLS-IET schemes. Note: Whenever possible, it
 	is a good idea to set this property when solving the QSTLS-IET schemes """
+        self.fixedPrecision : str = None
+        """ precision used to write the fixed components of the auxiliary density
+	response to file, allowed options include:
+
+	  - double: the fixed components are written in double precision
+
+	  - single: the fixed components are written in single precision. This
+	    halves the size of the files and the time needed to read them, but it
+	    can only be used if the accuracy of the integrals is not smaller than
+	    the single precision round-off error. Files written in either precision
+	    can be read by any calculation """
+        self.fixedLowRankError : float = None
+        """ relative error of the low-rank representation of the fixed components
+	of the auxiliary density response. If larger than zero, each frequency
+	slice of the fixed components is approximated with a truncated singular
+	value decomposition whose error, for each wave-vector, is smaller than
+	fixedLowRankError times the largest value of the fixed component at that
+	wave-vector. The low-rank representation is used to compute the
+	auxiliary density response and to store the fixed components of the
+	QSTLS-IET schemes """
+        self.progressInterval : float = None
+        """ interval in seconds between the progress reports printed while the
+	fixed components of the auxiliary density response are computed. Each
+	report contains the number of completed wave-vectors, the elapsed time
+	and an estimate of the remaining time, both as plain text and as a JSON
+	line. The reports require an MPI library that supports
+	``MPI_THREAD_SERIALIZED``. Default = ``0`` (no reports) """
         
 class QVSStlsInput(VSStlsInput, QstlsInput):
     """Class to handle the inputs related to the quantum VS-STLS scheme."""
@@ -142,3 +194,46 @@ class FreeEnergyIntegrand():
         """ The coupling parameter grid used to compute the free energy """
         self.integrand : np.ndarray = None
         """ The free energy integrand for various coupling parameter values """
+
+class ResourcePlan():
+    """Class used to estimate the resources needed to solve a scheme before the
+    scheme is solved. The estimate is obtained from the inputs of the scheme
+    (:obj:`RpaInput`, :obj:`StlsInput`, :obj:`VSStlsInput`, :obj:`QstlsInput` or
+    :obj:`QVSStlsInput`) and from the number of MPI processes of the current run,
+    unless a different number of processes is specified with :func:`setRanks`.
+    """
+    def __init__(self, inputs):
+        self.gridSize : int
+        """ Size of the wave-vector grid """
+        self.memoryPerRank : int
+        """ Peak memory (in bytes) for each process """
+        self.memoryPerNode : int
+        """ Peak memory (in bytes) for each node, including the memory shared among the
+        processes on the same node """
+        self.diskFixed : int
+        """ Disk space (in bytes) for the files with the fixed component of the auxiliary
+        density response """
+        self.diskCheckpoints : int
+        """ Disk space (in bytes) for the checkpoint files written while the fixed component
+        of the auxiliary density response is computed """
+        self.integralsIdr : int
+        """ Number of integrals for the ideal density response """
+        self.integralsFixed : int
+        """ Number of two-dimensional integrals for the fixed component of the auxiliary
+        density response """
+        self.integralsFixedIet : int
+        """ Number of one-dimensional integrals for the fixed component of the auxiliary
+        density response of the QSTLS-IET schemes """
+        self.runTimeFixed : float
+        """ Estimated run time (in seconds) for the fixed component of the auxiliary density
+        response. The estimate is available only after :func:`calibrate` is called """
+
+    def setRanks(self, ranks : int, ranksPerNode : int) -> None:
+        """ Sets the total number of MPI processes and the number of MPI processes on each node """
+        pass
+
+    def calibrate(self, rows : int) -> None:
+        """ Times a sample of the integrals for the fixed component of the auxiliary density
+        response on the current machine for the given number of wave-vectors. The measured
+        time is used to estimate the run time of the fixed component """
+        pass
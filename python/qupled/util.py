@@ -225,6 +225,10 @@ class MPI():
         """ Get rank of the process """
         return self.qpMPI.rank()
 
+    def getNumberOfRanks(self):
+        """ Get number of processes """
+        return self.qpMPI.numberOfRanks()
+    
     def isRoot(self):
         """ Check if the current process is root (rank 0) """
         return self.qpMPI.isRoot()
@@ -236,6 +240,39 @@ class MPI():
     def timer(self):
         """ Get wall time """
         return self.qpMPI.timer()
+
+    def getCommunicator(self):
+        """ Get the identifier of the communicator used by the solvers """
+        return self.qpMPI.getCommunicator()
+
+    def setCommunicator(self, commId):
+        """ Set the communicator used by the solvers. The solvers use the
+        communicator that is active when they are created. The identifier 0
+        refers to the communicator with all the processes """
+        self.qpMPI.setCommunicator(commId)
+
+    def splitCommunicator(self, color):
+        """ Split the processes in groups with the same color and return the
+        identifier of the communicator for the group of the current process """
+        return self.qpMPI.splitCommunicator(color)
+
+    def freeCommunicator(self, commId):
+        """ Free a communicator obtained from splitCommunicator. The
+        communicator must not be active and the solvers created while it was
+        active can no longer be used """
+        self.qpMPI.freeCommunicator(commId)
+
+    def splitRanks(self, nGroups):
+        """ Split the processes in nGroups groups of contiguous ranks and
+        activate the communicator of the group of the current process. This
+        allows to run independent calculations concurrently, one per group.
+        Returns the index of the group of the current process """
+        nRanks = self.getNumberOfRanks()
+        if (nGroups < 1 or nGroups > nRanks):
+            sys.exit("The number of groups must be between 1 and the number of processes")
+        group = self.getRank() * nGroups // nRanks
+        self.setCommunicator(self.splitCommunicator(group))
+        return group
         
     @staticmethod
     def runOnlyOnRoot(func):
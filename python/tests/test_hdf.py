@@ -146,3 +146,16 @@ def test_computeInternalEnergy(hdf_instance):
         assert uint == 0.0
     finally:
         os.remove(hdfFileName)
+
+def test_computeInternalEnergyLinearSsf(hdf_instance):
+    hdfFileName="testOutput.h5"
+    mockRdfOutput(hdfFileName)
+    try:
+        wvgData = np.arange(0, 5, 0.1)
+        pd.DataFrame(1.0 + 0.1 * wvgData).to_hdf(hdfFileName, key="ssf")
+        uint = hdf_instance.computeInternalEnergy(hdfFileName)
+        lam = (4.0 / (9.0 * np.pi)) ** (1.0 / 3.0)
+        expected = 0.05 * wvgData[-1]**2 / (np.pi * lam)
+        assert uint == pytest.approx(expected, rel=1e-12)
+    finally:
+        os.remove(hdfFileName)
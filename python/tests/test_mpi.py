@@ -0,0 +1,43 @@
+import pytest
+import set_path
+from qupled.util import MPI
+
+@pytest.fixture
+def mpi_instance():
+    return MPI()
+
+def test_communicator(mpi_instance):
+    assert mpi_instance.getCommunicator() == 0
+    assert mpi_instance.getNumberOfRanks() == 1
+    commId = mpi_instance.splitCommunicator(0)
+    assert commId > 0
+    mpi_instance.setCommunicator(commId)
+    assert mpi_instance.getCommunicator() == commId
+    assert mpi_instance.getRank() == 0
+    assert mpi_instance.isRoot()
+    mpi_instance.setCommunicator(0)
+    assert mpi_instance.getCommunicator() == 0
+
+def test_freeCommunicator(mpi_instance):
+    commId = mpi_instance.splitCommunicator(0)
+    mpi_instance.setCommunicator(commId)
+    with pytest.raises(RuntimeError) as excinfo:
+        mpi_instance.freeCommunicator(commId)
+    assert excinfo.value.args[0] == "The active communicator can't be freed"
+    mpi_instance.setCommunicator(0)
+    mpi_instance.freeCommunicator(commId)
+    with pytest.raises(RuntimeError) as excinfo:
+        mpi_instance.setCommunicator(commId)
+    assert excinfo.value.args[0] == "Invalid communicator: " + str(commId)
+    with pytest.raises(RuntimeError) as excinfo:
+        mpi_instance.freeCommunicator(0)
+    assert excinfo.value.args[0] == "Invalid communicator: 0"
+
+def test_splitRanks(mpi_instance, mocker):
+    mockExit = mocker.patch("sys.exit")
+    assert mpi_instance.splitRanks(1) == 0
+    assert mpi_instance.getCommunicator() > 0
+    mpi_instance.setCommunicator(0)
+    mpi_instance.splitRanks(2)
+    assert mockExit.call_count == 1
+    mpi_instance.setCommunicator(0)
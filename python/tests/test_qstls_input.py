@@ -18,6 +18,9 @@ def test_init(qstls_input_instance):
     assert hasattr(qstls_input_instance.guess, "matsubara")
     assert hasattr(qstls_input_instance, "fixed")
     assert hasattr(qstls_input_instance, "fixediet")
+    assert hasattr(qstls_input_instance, "fixedPrecision")
+    assert hasattr(qstls_input_instance, "fixedLowRankError")
+    assert hasattr(qstls_input_instance, "progressInterval")
     
 def test_defaults(qstls_input_instance):
     assert qstls_input_instance.guess.wvg.size == 0
@@ -26,6 +29,9 @@ def test_defaults(qstls_input_instance):
     assert qstls_input_instance.guess.matsubara  == 0
     assert qstls_input_instance.fixed == ""
     assert qstls_input_instance.fixediet == ""
+    assert qstls_input_instance.fixedPrecision == "double"
+    assert qstls_input_instance.fixedLowRankError == 0
+    assert qstls_input_instance.progressInterval == 0
     
 def test_fixed(qstls_input_instance):
     qstls_input_instance.fixed = "fixedFile"
@@ -36,6 +42,33 @@ def test_fixed(qstls_input_instance):
     qstls_input_instance.fixediet = "fixedFile"
     fixed = qstls_input_instance.fixediet
     assert fixed == "fixedFile"
+
+
+def test_fixedPrecision(qstls_input_instance):
+    for precision in ["single", "double"]:
+        qstls_input_instance.fixedPrecision = precision
+        thisPrecision = qstls_input_instance.fixedPrecision
+        assert thisPrecision == precision
+    with pytest.raises(RuntimeError) as excinfo:
+        qstls_input_instance.fixedPrecision = "half"
+    assert excinfo.value.args[0] == "Unknown precision for the fixed component: half"
+
+
+def test_fixedLowRankError(qstls_input_instance):
+    qstls_input_instance.fixedLowRankError = 1e-6
+    fixedLowRankError = qstls_input_instance.fixedLowRankError
+    assert fixedLowRankError == 1e-6
+    with pytest.raises(RuntimeError) as excinfo:
+        qstls_input_instance.fixedLowRankError = -1e-6
+    assert excinfo.value.args[0] == "The error of the low-rank fixed component can't be negative"
+
+def test_progressInterval(qstls_input_instance):
+    qstls_input_instance.progressInterval = 30
+    progressInterval = qstls_input_instance.progressInterval
+    assert progressInterval == 30
+    with pytest.raises(RuntimeError) as excinfo:
+        qstls_input_instance.progressInterval = -1
+    assert excinfo.value.args[0] == "The interval for the progress reports can't be negative"
     
 def test_guess(qstls_input_instance):
     arr = np.zeros(10)
@@ -110,3 +143,6 @@ def test_print(qstls_input_instance, capfd):
     assert "File with recovery data = " in captured
     assert "File with fixed adr component = " in captured
     assert "File with fixed adr component (iet) = " in captured
+    assert "Precision of the fixed adr component = double" in captured
+    assert "Error of the low-rank fixed adr component = 0" in captured
+    assert "Interval for the progress reports (s) = 0" in captured
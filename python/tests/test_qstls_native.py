@@ -1,6 +1,8 @@
 import os
 import pytest
 import glob
+import struct
+import numpy as np
 import set_path
 import qupled.qupled as qp
 import qupled.quantum as qpq
@@ -38,12 +40,197 @@ def test_qstls_compute():
         if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
         if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
 
+def test_qstls_fixed_single():
+    inputs = qpq.Qstls(1.0, 1.0,
+                       matsubara=16,
+                       cutoff=5,
+                       threads=16).inputs
+    inputs.fixedPrecision = "single"
+    fixedFile = "adr_fixed_theta1.000_matsubara16.bin"
+    scheme = qp.Qstls(inputs)
+    scheme.compute()
+    try:
+        # The files written in single precision have a negative number
+        # of wave-vectors in the header
+        with open(fixedFile, "rb") as file:
+            nx, nl = struct.unpack("ii", file.read(8))
+        assert nx == -scheme.wvg.size
+        assert nl == inputs.matsubara
+        inputs.fixed = fixedFile
+        schemeFixed = qp.Qstls(inputs)
+        schemeFixed.compute()
+        assert schemeFixed.ssf == pytest.approx(scheme.ssf, rel=1e-6)
+        assert schemeFixed.adr == pytest.approx(scheme.adr, rel=1e-5, abs=1e-8)
+    finally:
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+        if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+
+def test_qstls_compute_ground():
+    inputs = qpq.Qstls(1.0, 0.0,
+                       matsubara=16,
+                       cutoff=5,
+                       threads=16).inputs
+    scheme = qp.Qstls(inputs)
+    scheme.compute()
+    try:
+        nx = scheme.wvg.size
+        assert nx >= 3
+        assert scheme.adr.shape[0] == nx
+        assert scheme.adr.shape[1] == inputs.matsubara
+        assert scheme.idr.shape[0] == nx
+        assert scheme.idr.shape[1] == inputs.matsubara
+        assert scheme.slfc.size == nx
+        assert scheme.ssf.size == nx
+        assert scheme.ssf[0] == 0.0
+        assert all(scheme.ssf[1:] > 0.0)
+        assert abs(scheme.uInt + 0.5567) < 1e-3
+    finally:
+        fixedFile = "adr_fixed_theta0.000_matsubara16.bin"
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+        if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+
+def test_qstls_step():
+    inputs = qpq.Qstls(1.0, 1.0,
+                       matsubara=32,
+                       cutoff=5,
+                       threads=16).inputs
+    scheme = qp.Qstls(inputs)
+    assert scheme.init() == 0
+    errors = []
+    scheme.setCallback(lambda iteration, error : errors.append(error))
+    try:
+        assert scheme.state()["iteration"] == 0
+        assert scheme.step(1) == 0
+        ssf = scheme.ssf
+        assert scheme.state()["iteration"] == 1
+        assert scheme.step(1) == 0
+        assert scheme.state()["iteration"] == 2
+        assert len(errors) == 2
+        assert scheme.state()["error"] == errors[-1]
+        assert (scheme.ssf != ssf).any()
+    finally:
+        fixedFile = "adr_fixed_theta1.000_matsubara32.bin"
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+        if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+
+def test_qstls_low_rank():
+    adr = {}
+    ssf = {}
+    for lowRankError in [0.0, 1e-8]:
+        inputs = qpq.Qstls(1.0, 1.0,
+                           matsubara=16,
+                           cutoff=5,
+                           threads=16).inputs
+        inputs.fixedLowRankError = lowRankError
+        scheme = qp.Qstls(inputs)
+        scheme.compute()
+        try:
+            adr[lowRankError] = scheme.adr
+            ssf[lowRankError] = scheme.ssf
+        finally:
+            fixedFile = "adr_fixed_theta1.000_matsubara16.bin"
+            if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+            if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+    # The adr from the low-rank representation must match the adr from
+    # the full fixed component
+    assert adr[1e-8] == pytest.approx(adr[0.0], rel=1e-4, abs=1e-7)
+    assert ssf[1e-8] == pytest.approx(ssf[0.0], rel=1e-6)
+
+def test_qstls_checkpoint_restart():
+    inputs = qpq.Qstls(1.0, 1.0,
+                       matsubara=16,
+                       cutoff=5,
+                       threads=16).inputs
+    fixedFile = "adr_fixed_theta1.000_matsubara16.bin"
+    checkpoint = "adr_fixed_theta1.000_matsubara16_group0_rank0.chk"
+    scheme = qp.Qstls(inputs)
+    scheme.compute()
+    try:
+        with open(fixedFile, "rb") as file:
+            header = file.read(16)
+            nx, nl = struct.unpack("ii", header[:8])
+            wvg = file.read(8 * nx)
+            fixed = np.fromfile(file, dtype=np.float64).reshape(nx, nl * nx)
+    finally:
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+        if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+    # Checkpoint left by an interrupted calculation: every other row of
+    # the fixed component followed by a row that was only partially written
+    with open(checkpoint, "wb") as file:
+        file.write(header + wvg)
+        for i in range(0, nx, 2):
+            file.write(struct.pack("i", i) + fixed[i].tobytes())
+        file.write(struct.pack("i", 1) + fixed[1, :nx].tobytes())
+    schemeRestart = qp.Qstls(inputs)
+    schemeRestart.compute()
+    try:
+        assert schemeRestart.adr == pytest.approx(scheme.adr, rel=1e-10, abs=1e-14)
+        assert schemeRestart.ssf == pytest.approx(scheme.ssf, rel=1e-10)
+        assert glob.glob("adr_fixed_*.chk") == []
+    finally:
+        if (os.path.isfile(checkpoint)) : os.remove(checkpoint)
+        if (os.path.isfile(schemeRestart.recovery)) : os.remove(schemeRestart.recovery)
+        if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
+
+def readAdrFixedIetFile(fileName):
+    with open(fileName, "rb") as file:
+        nx, nl = struct.unpack("ii", file.read(8))
+        file.read(8 * (nx + 1))
+        if nl > 0:
+            return np.fromfile(file, dtype=np.float64).reshape(nl, nx, nx)
+        out = np.zeros((-nl, nx, nx))
+        for l in range(-nl):
+            rank = struct.unpack("i", file.read(4))[0]
+            if rank < 0:
+                out[l] = np.fromfile(file, dtype=np.float64, count=nx * nx).reshape(nx, nx)
+                continue
+            u = np.fromfile(file, dtype=np.float64, count=rank * nx).reshape(rank, nx)
+            v = np.fromfile(file, dtype=np.float64, count=rank * nx).reshape(rank, nx)
+            out[l] = u.T @ v
+        return out
+
+def test_qstls_iet_low_rank():
+    relErr = 1e-6
+    fixed = {}
+    ssf = {}
+    for lowRankError in [0.0, relErr]:
+        inputs = qpq.QstlsIet(10.0, 1.0, "QSTLS-HNC",
+                              matsubara=16,
+                              cutoff=5,
+                              mixing=0.5,
+                              threads=16).inputs
+        inputs.fixedLowRankError = lowRankError
+        scheme = qp.Qstls(inputs)
+        scheme.compute()
+        try:
+            ssf[lowRankError] = scheme.ssf
+            fixed[lowRankError] = {fileName : readAdrFixedIetFile(fileName)
+                                   for fileName in glob.glob("adr_fixed*_wv*.bin")}
+        finally:
+            if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+            fileNames = glob.glob("adr_fixed*.bin")
+            for fileName in fileNames :
+                os.remove(fileName)
+    # The error of each row of the low-rank representation, relative to
+    # the largest element of the row, must not exceed the requested error
+    assert fixed[relErr].keys() == fixed[0.0].keys()
+    for fileName, full in fixed[0.0].items():
+        err = np.abs(fixed[relErr][fileName] - full).max(axis=2)
+        rowMax = np.abs(full).max(axis=2)
+        assert (err <= (relErr + 1e-12) * rowMax).all()
+    assert ssf[relErr] == pytest.approx(ssf[0.0], rel=1e-5)
 
 def test_qstls_iet_properties():
     inputs = qpq.QstlsIet(1.0, 1.0, "QSTLS-HNC").inputs
     scheme = qp.Qstls(inputs)
     assert hasattr(scheme, "bf")
 
+def test_qstls_iet_ground():
+    inputs = qpq.QstlsIet(1.0, 0.0, "QSTLS-HNC").inputs
+    with pytest.raises(RuntimeError) as excinfo:
+        qp.Qstls(inputs)
+    assert excinfo.value.args[0] == "Ground state calculations are not available for the quantum iet schemes"
+
 def test_qstls_iet_compute():
     ietSchemes = {"QSTLS-HNC",
                   "QSTLS-IOI",
@@ -13,9 +13,11 @@ def test_init(qvsstls_input_instance):
     assert issubclass(qp.QVSStlsInput, qp.QstlsInput)
     assert hasattr(qvsstls_input_instance, "errorAlpha")
     assert hasattr(qvsstls_input_instance, "iterationsAlpha")
+    assert hasattr(qvsstls_input_instance, "groupsAlpha")
     assert hasattr(qvsstls_input_instance, "alpha")
     assert hasattr(qvsstls_input_instance, "couplingResolution")
     assert hasattr(qvsstls_input_instance, "degeneracyResolution")
+    assert hasattr(qvsstls_input_instance, "freeEnergyCouplingResolution")
     assert hasattr(qvsstls_input_instance, "freeEnergyIntegrand")
     assert hasattr(qvsstls_input_instance, "guess")
     assert hasattr(qvsstls_input_instance.guess, "wvg")
@@ -29,9 +31,11 @@ def test_init(qvsstls_input_instance):
 def test_defaults(qvsstls_input_instance):
     assert qvsstls_input_instance.errorAlpha == 0
     assert qvsstls_input_instance.iterationsAlpha == 0
+    assert qvsstls_input_instance.groupsAlpha == 1
     assert all(x == y for x, y in zip(qvsstls_input_instance.alpha, [0, 0]))
     assert qvsstls_input_instance.couplingResolution == 0
     assert qvsstls_input_instance.degeneracyResolution == 0
+    assert qvsstls_input_instance.freeEnergyCouplingResolution == 0
     assert qvsstls_input_instance.freeEnergyIntegrand.grid.size == 0
     assert qvsstls_input_instance.freeEnergyIntegrand.integrand.size == 0
     assert qvsstls_input_instance.guess.wvg.size == 0
@@ -61,6 +65,15 @@ def test_iterationsAlpha(qvsstls_input_instance):
         qvsstls_input_instance.iterationsAlpha = -2
     assert excinfo.value.args[0] == "The maximum number of iterations can't be negative"    
 
+def test_groupsAlpha(qvsstls_input_instance):
+    qvsstls_input_instance.groupsAlpha = 4
+    groupsAlpha = qvsstls_input_instance.groupsAlpha
+    assert groupsAlpha == 4
+    for groups in [0, -1]:
+        with pytest.raises(RuntimeError) as excinfo:
+            qvsstls_input_instance.groupsAlpha = groups
+        assert excinfo.value.args[0] == "The number of groups for the free parameter must be larger than zero"
+
 def test_alpha(qvsstls_input_instance):
     qvsstls_input_instance.alpha = [-10, 10]
     alpha = qvsstls_input_instance.alpha
@@ -85,6 +98,14 @@ def test_degeneracyResolution(qvsstls_input_instance):
     with pytest.raises(RuntimeError) as excinfo:
         qvsstls_input_instance.degeneracyResolution = -0.1
     assert excinfo.value.args[0] == "The degeneracy parameter resolution must be larger than zero"  
+
+def test_freeEnergyCouplingResolution(qvsstls_input_instance):
+    qvsstls_input_instance.freeEnergyCouplingResolution = 0.5
+    freeEnergyCouplingResolution = qvsstls_input_instance.freeEnergyCouplingResolution
+    assert freeEnergyCouplingResolution == 0.5
+    with pytest.raises(RuntimeError) as excinfo:
+        qvsstls_input_instance.freeEnergyCouplingResolution = -0.1
+    assert excinfo.value.args[0] == "The coupling parameter resolution for the free energy can't be negative"
     
 def test_freeEnergyIntegrand(qvsstls_input_instance):
     arr1 = np.zeros(10)
@@ -150,6 +171,8 @@ def test_print(qvsstls_input_instance, capfd):
     assert "Guess for the free parameter = 0,0" in captured
     assert "Resolution for the coupling parameter grid = 0" in captured
     assert "Resolution for the degeneracy parameter grid = 0" in captured
+    assert "Resolution for the free energy coupling parameter grid = 0" in captured
     assert "Minimum error for convergence (alpha) = 0" in captured
     assert "Maximum number of iterations (alpha) = 0" in captured
+    assert "Number of groups of ranks (alpha) = 1" in captured
     assert "File with fixed adr component = " in captured
@@ -1,5 +1,7 @@
 import os
+import struct
 import pytest
+import numpy as np
 import set_path
 import qupled.qupled as qp
 import qupled.quantum as qpq
@@ -43,3 +45,49 @@ def test_qvsstls_compute():
         if (os.path.isfile(fixedFile)) : os.remove(fixedFile)
         if (os.path.isfile(fixedFilep)) : os.remove(fixedFilep)
 
+
+def readAdrFixedFile(fileName):
+    with open(fileName, "rb") as file:
+        nx, nl = struct.unpack("ii", file.read(8))
+        file.read(8 * (nx + 1))
+        return np.fromfile(file, dtype=np.float64).reshape(nx, nl, nx)
+
+def test_qvsstls_fixed_components():
+    inputs = qpq.QVSStls(1.0, 1.0,
+                         matsubara=16,
+                         couplingResolution=0.5,
+                         degeneracyResolution=0.1,
+                         cutoff=5,
+                         threads=16).inputs
+    fixedFiles = {theta : "adr_fixed_theta%.3f_matsubara16.bin" % theta
+                  for theta in [0.9, 1.0, 1.1]}
+    scheme = qp.QVSStls(inputs)
+    fixed = {}
+    try:
+        assert scheme.compute() == 0
+        for theta, fileName in fixedFiles.items():
+            fixed[theta] = readAdrFixedFile(fileName)
+    finally:
+        for fileName in fixedFiles.values():
+            if (os.path.isfile(fileName)) : os.remove(fileName)
+    # The fixed components computed together for the three degeneracy
+    # parameters must match the ones computed separately by qstls
+    for theta, fileName in fixedFiles.items():
+        inputsQstls = qpq.Qstls(1.0, theta,
+                                matsubara=16,
+                                cutoff=5,
+                                threads=16).inputs
+        schemeQstls = qp.Qstls(inputsQstls)
+        try:
+            assert schemeQstls.compute() == 0
+            ref = readAdrFixedFile(fileName)
+        finally:
+            if (os.path.isfile(schemeQstls.recovery)) : os.remove(schemeQstls.recovery)
+            if (os.path.isfile(fileName)) : os.remove(fileName)
+        assert fixed[theta] == pytest.approx(ref, rel=0, abs=1e-3 * np.abs(ref).max())
+
+def test_qvsstls_ground():
+    inputs = qpq.QVSStls(1.0, 0.0).inputs
+    with pytest.raises(RuntimeError) as excinfo:
+        qp.QVSStls(inputs)
+    assert excinfo.value.args[0] == "Ground state calculations are not available for the quantum VS scheme"
@@ -0,0 +1,68 @@
+import pytest
+import set_path
+import qupled.qupled as qp
+import qupled.classic as qpc
+import qupled.quantum as qpq
+
+def test_resource_plan_properties():
+    plan = qp.ResourcePlan(qpc.Rpa(1.0, 1.0).inputs)
+    assert hasattr(plan, "gridSize")
+    assert hasattr(plan, "memoryPerRank")
+    assert hasattr(plan, "memoryPerNode")
+    assert hasattr(plan, "diskFixed")
+    assert hasattr(plan, "diskCheckpoints")
+    assert hasattr(plan, "integralsIdr")
+    assert hasattr(plan, "integralsFixed")
+    assert hasattr(plan, "integralsFixedIet")
+    assert hasattr(plan, "runTimeFixed")
+
+def test_resource_plan_classic():
+    inputs = qpc.Stls(1.0, 1.0, matsubara=16, cutoff=5, resolution=0.1).inputs
+    plan = qp.ResourcePlan(inputs)
+    nx = plan.gridSize
+    assert nx == 52
+    assert plan.memoryPerRank >= nx * 16 * 8
+    assert plan.memoryPerNode == plan.memoryPerRank
+    assert plan.diskFixed == 0
+    assert plan.diskCheckpoints == 0
+    assert plan.integralsIdr == nx * 16
+    assert plan.integralsFixed == 0
+    assert plan.integralsFixedIet == 0
+    assert plan.runTimeFixed == 0.0
+    with pytest.raises(RuntimeError) as excinfo:
+        plan.calibrate(1)
+    assert excinfo.value.args[0] == "The run time can be estimated only for the quantum schemes at finite temperature"
+
+def test_resource_plan_quantum():
+    inputs = qpq.Qstls(1.0, 1.0, matsubara=16, cutoff=5, resolution=0.1).inputs
+    plan = qp.ResourcePlan(inputs)
+    nx = plan.gridSize
+    fixedSize = nx * 16 * nx * 8
+    assert plan.memoryPerNode >= plan.memoryPerRank + fixedSize
+    assert plan.diskFixed > fixedSize
+    assert plan.diskCheckpoints > fixedSize
+    assert plan.integralsFixed == (nx - 1) * 16 * nx
+    assert plan.integralsFixedIet == 0
+    plan.calibrate(1)
+    assert plan.runTimeFixed > 0.0
+    inputs.fixed = "adr_fixed_theta1.000_matsubara16.bin"
+    plan = qp.ResourcePlan(inputs)
+    assert plan.diskFixed == 0
+    assert plan.integralsFixed == 0
+
+def test_resource_plan_quantum_iet():
+    inputs = qpq.QstlsIet(1.0, 1.0, "QSTLS-HNC", matsubara=16, cutoff=5, resolution=0.1).inputs
+    plan = qp.ResourcePlan(inputs)
+    nx = plan.gridSize
+    assert plan.diskFixed > nx * 16 * nx * nx * 8
+    assert plan.integralsFixedIet == (nx - 1) * 16 * (nx - 1) * nx
+
+def test_resource_plan_ranks():
+    inputs = qpq.QVSStls(1.0, 1.0, matsubara=16, cutoff=5, resolution=0.1).inputs
+    plan = qp.ResourcePlan(inputs)
+    memoryPerNode = plan.memoryPerNode
+    plan.setRanks(4, 2)
+    assert plan.memoryPerNode == memoryPerNode + plan.memoryPerRank
+    with pytest.raises(RuntimeError) as excinfo:
+        plan.setRanks(2, 4)
+    assert excinfo.value.args[0] == "The number of processes on each node can't be larger than the total number of processes"
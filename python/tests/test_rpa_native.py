@@ -34,3 +34,15 @@ def test_rpa_compute():
 
 
 
+
+def test_rpa_compute_ground():
+    inputs = qpc.Rpa(1.0, 0.0).inputs
+    inputs.threads = 2
+    scheme = qp.Rpa(inputs)
+    scheme.compute()
+    nx = scheme.wvg.size
+    assert nx >= 3
+    assert scheme.ssf.size == nx
+    assert scheme.ssf[0] == 0.0
+    assert all(scheme.ssf[1:] > 0.0)
+    assert abs(scheme.ssf[-1] - 1.0) < 1e-3
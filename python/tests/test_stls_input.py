@@ -12,6 +12,7 @@ def stls_input_instance():
 def test_init(stls_input_instance):
     assert issubclass(qp.StlsInput, qp.RpaInput)
     assert hasattr(stls_input_instance, "error")
+    assert hasattr(stls_input_instance, "errorIntegralsScaling")
     assert hasattr(stls_input_instance, "mixing")
     assert hasattr(stls_input_instance, "iet")
     assert hasattr(stls_input_instance, "iterations")
@@ -23,6 +24,7 @@ def test_init(stls_input_instance):
         
 def test_defaults(stls_input_instance):
     assert stls_input_instance.error == 0
+    assert stls_input_instance.errorIntegralsScaling == 0
     assert stls_input_instance.mixing == 0
     assert stls_input_instance.iet == ""
     assert stls_input_instance.iterations == 0
@@ -39,6 +41,14 @@ def test_error(stls_input_instance):
         stls_input_instance.error = -0.1
     assert excinfo.value.args[0] == "The minimum error for convergence must be larger than zero"    
 
+def test_errorIntegralsScaling(stls_input_instance):
+    stls_input_instance.errorIntegralsScaling = 0.1
+    errorIntegralsScaling = stls_input_instance.errorIntegralsScaling
+    assert errorIntegralsScaling == 0.1
+    with pytest.raises(RuntimeError) as excinfo:
+        stls_input_instance.errorIntegralsScaling = -0.1
+    assert excinfo.value.args[0] == "The scaling factor for the accuracy of the integrals can't be negative"
+
 def test_mixing(stls_input_instance):
     stls_input_instance.mixing = 0.5
     mixing = stls_input_instance.mixing
@@ -127,6 +137,7 @@ def test_print(stls_input_instance, capfd):
     assert "Iet mapping scheme = " in captured
     assert "Maximum number of iterations = 0" in captured
     assert "Minimum error for convergence = 0" in captured
+    assert "Scaling factor for the accuracy of the integrals = 0" in captured
     assert "Mixing parameter = 0" in captured
     assert "Output frequency = 0" in captured
     assert "File with recovery data = " in captured
@@ -1,5 +1,6 @@
 import os
 import pytest
+import numpy as np
 import set_path
 import qupled.qupled as qp
 import qupled.classic as qpc
@@ -28,6 +29,60 @@ def test_stls_compute():
     finally:
         if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
 
+def test_stls_step():
+    inputs = qpc.Stls(1.0, 1.0).inputs
+    scheme = qp.Stls(inputs)
+    assert scheme.init() == 0
+    try:
+        state = scheme.state()
+        assert state["iteration"] == 0
+        assert not state["converged"]
+        assert scheme.step(2) == 0
+        state = scheme.state()
+        assert state["iteration"] == 2
+        assert state["error"] > inputs.error
+        assert scheme.step(inputs.iterations) == 0
+        state = scheme.state()
+        assert state["converged"]
+        assert state["error"] <= inputs.error
+        assert scheme.step(1) == 0
+        assert scheme.state()["iteration"] == state["iteration"]
+    finally:
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+
+def test_stls_callback():
+    inputs = qpc.Stls(1.0, 1.0).inputs
+    scheme = qp.Stls(inputs)
+    errors = []
+    def callback(iteration, error):
+        errors.append(error)
+        return iteration < 3
+    scheme.setCallback(callback)
+    scheme.compute()
+    try:
+        assert len(errors) == 3
+        assert scheme.state()["iteration"] == 3
+        assert scheme.state()["error"] == errors[-1]
+    finally:
+        if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+
+def test_stls_ground_error_scaling():
+    ssf = []
+    for scaling in [0.0, 1.0]:
+        inputs = qpc.Stls(1.0, 0.0).inputs
+        inputs.intError = 1e-10
+        inputs.errorIntegralsScaling = scaling
+        scheme = qp.Stls(inputs)
+        assert scheme.init() == 0
+        try:
+            assert scheme.step(1) == 0
+            ssf.append(scheme.ssf)
+        finally:
+            if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recovery)
+    # The first iteration uses a relaxed accuracy only if the scaling is set
+    assert np.any(ssf[0] != ssf[1])
+    assert np.allclose(ssf[0], ssf[1], rtol=1e-3)
+
 def test_stls_iet_compute():
     ietSchemes = {"STLS-HNC",
                   "STLS-IOI",
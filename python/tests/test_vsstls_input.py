@@ -13,9 +13,11 @@ def test_init(vsstls_input_instance):
     assert issubclass(qp.VSStlsInput, qp.StlsInput)
     assert hasattr(vsstls_input_instance, "errorAlpha")
     assert hasattr(vsstls_input_instance, "iterationsAlpha")
+    assert hasattr(vsstls_input_instance, "groupsAlpha")
     assert hasattr(vsstls_input_instance, "alpha")
     assert hasattr(vsstls_input_instance, "couplingResolution")
     assert hasattr(vsstls_input_instance, "degeneracyResolution")
+    assert hasattr(vsstls_input_instance, "freeEnergyCouplingResolution")
     assert hasattr(vsstls_input_instance, "freeEnergyIntegrand")
     assert hasattr(vsstls_input_instance.freeEnergyIntegrand, "grid")
     assert hasattr(vsstls_input_instance.freeEnergyIntegrand, "integrand")
@@ -23,9 +25,11 @@ def test_init(vsstls_input_instance):
 def test_defaults(vsstls_input_instance):
     assert vsstls_input_instance.errorAlpha == 0
     assert vsstls_input_instance.iterationsAlpha == 0
+    assert vsstls_input_instance.groupsAlpha == 1
     assert all(x == y for x, y in zip(vsstls_input_instance.alpha, [0, 0]))
     assert vsstls_input_instance.couplingResolution == 0
     assert vsstls_input_instance.degeneracyResolution == 0
+    assert vsstls_input_instance.freeEnergyCouplingResolution == 0
     assert vsstls_input_instance.freeEnergyIntegrand.grid.size == 0
     assert vsstls_input_instance.freeEnergyIntegrand.integrand.size == 0
     
@@ -45,6 +49,15 @@ def test_iterationsAlpha(vsstls_input_instance):
         vsstls_input_instance.iterationsAlpha = -2
     assert excinfo.value.args[0] == "The maximum number of iterations can't be negative"    
 
+def test_groupsAlpha(vsstls_input_instance):
+    vsstls_input_instance.groupsAlpha = 4
+    groupsAlpha = vsstls_input_instance.groupsAlpha
+    assert groupsAlpha == 4
+    for groups in [0, -1]:
+        with pytest.raises(RuntimeError) as excinfo:
+            vsstls_input_instance.groupsAlpha = groups
+        assert excinfo.value.args[0] == "The number of groups for the free parameter must be larger than zero"
+
 def test_alpha(vsstls_input_instance):
     vsstls_input_instance.alpha = [-10, 10]
     alpha = vsstls_input_instance.alpha
@@ -69,6 +82,14 @@ def test_degeneracyResolution(vsstls_input_instance):
     with pytest.raises(RuntimeError) as excinfo:
         vsstls_input_instance.degeneracyResolution = -0.1
     assert excinfo.value.args[0] == "The degeneracy parameter resolution must be larger than zero"  
+
+def test_freeEnergyCouplingResolution(vsstls_input_instance):
+    vsstls_input_instance.freeEnergyCouplingResolution = 0.5
+    freeEnergyCouplingResolution = vsstls_input_instance.freeEnergyCouplingResolution
+    assert freeEnergyCouplingResolution == 0.5
+    with pytest.raises(RuntimeError) as excinfo:
+        vsstls_input_instance.freeEnergyCouplingResolution = -0.1
+    assert excinfo.value.args[0] == "The coupling parameter resolution for the free energy can't be negative"
     
 def test_freeEnergyIntegrand(vsstls_input_instance):
     arr1 = np.zeros(10)
@@ -134,5 +155,7 @@ def test_print(vsstls_input_instance, capfd):
     assert "Guess for the free parameter = 0,0" in captured
     assert "Resolution for the coupling parameter grid = 0" in captured
     assert "Resolution for the degeneracy parameter grid = 0" in captured
+    assert "Resolution for the free energy coupling parameter grid = 0" in captured
     assert "Minimum error for convergence (alpha) = 0" in captured
     assert "Maximum number of iterations (alpha) = 0" in captured
+    assert "Number of groups of ranks (alpha) = 1" in captured
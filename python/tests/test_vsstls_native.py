@@ -1,4 +1,7 @@
 import os
+import sys
+import shutil
+import subprocess
 import pytest
 import set_path
 import qupled.qupled as qp
@@ -10,6 +13,7 @@ def test_vsstls_properties():
     scheme = qp.VSStls(inputs)
     assert hasattr(scheme, "freeEnergyIntegrand")
     assert hasattr(scheme, "freeEnergyGrid")
+    assert hasattr(scheme, "alpha")
     
 def test_vsstls_compute():
     inputs = qpc.VSStls(1.0, 1.0,
@@ -32,3 +36,63 @@ def test_vsstls_compute():
     finally:
         if (os.path.isfile(scheme.recovery)) : os.remove(scheme.recover)
 
+def test_vsstls_ground_mpi(tmp_path):
+    mpiexec = shutil.which("mpiexec")
+    if mpiexec is None:
+        pytest.skip("mpiexec is not available")
+    # The state points are distributed among two ranks, hence each rank
+    # solves a different number of state points
+    script = tmp_path / "vsstls_ground.py"
+    script.write_text(
+        "import qupled.qupled as qp\n"
+        "import qupled.classic as qpc\n"
+        "from qupled.util import MPI\n"
+        "inputs = qpc.VSStls(1.0, 0.0, couplingResolution=0.1,\n"
+        "                    degeneracyResolution=0.1, cutoff=5).inputs\n"
+        "scheme = qp.VSStls(inputs)\n"
+        "assert scheme.compute() == 0\n"
+        "if MPI().isRoot(): print(repr(scheme.uInt))\n"
+    )
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+    out = subprocess.run([mpiexec, "-n", "2", sys.executable, str(script)],
+                         cwd=tmp_path, env=env, capture_output=True,
+                         text=True, timeout=600)
+    assert out.returncode == 0
+    inputs = qpc.VSStls(1.0, 0.0,
+                        couplingResolution=0.1,
+                        degeneracyResolution=0.1,
+                        cutoff=5).inputs
+    scheme = qp.VSStls(inputs)
+    assert scheme.compute() == 0
+    assert float(out.stdout.split()[-1]) == pytest.approx(scheme.uInt)
+
+def test_vsstls_groups_alpha_mpi(tmp_path):
+    mpiexec = shutil.which("mpiexec")
+    if mpiexec is None:
+        pytest.skip("mpiexec is not available")
+    # The free parameter is bracketed concurrently by two groups of one
+    # rank each before the secant solver is started
+    script = tmp_path / "vsstls_groups.py"
+    script.write_text(
+        "import qupled.qupled as qp\n"
+        "import qupled.classic as qpc\n"
+        "from qupled.util import MPI\n"
+        "inputs = qpc.VSStls(1.0, 0.0, couplingResolution=0.1,\n"
+        "                    degeneracyResolution=0.1, cutoff=5).inputs\n"
+        "inputs.groupsAlpha = 2\n"
+        "scheme = qp.VSStls(inputs)\n"
+        "assert scheme.compute() == 0\n"
+        "if MPI().isRoot(): print(repr(scheme.alpha))\n"
+    )
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+    out = subprocess.run([mpiexec, "-n", "2", sys.executable, str(script)],
+                         cwd=tmp_path, env=env, capture_output=True,
+                         text=True, timeout=600)
+    assert out.returncode == 0
+    inputs = qpc.VSStls(1.0, 0.0,
+                        couplingResolution=0.1,
+                        degeneracyResolution=0.1,
+                        cutoff=5).inputs
+    scheme = qp.VSStls(inputs)
+    assert scheme.compute() == 0
+    assert float(out.stdout.split()[-1]) == pytest.approx(scheme.alpha, rel=1e-3)
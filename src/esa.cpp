@@ -11,6 +11,7 @@ using namespace std;
 
 // Compute scheme
 int ESA::compute(){
+  parallelUtil::MPI::CommunicatorScope commScope(comm);
   try {
     init();
     if (verbose) cout << "Structural properties calculation ..." << endl;
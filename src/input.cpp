@@ -143,6 +143,13 @@ void StlsInput::setErrMin(const double &errMin){
   this->errMin = errMin;
 }
 
+void StlsInput::setIntErrorScaling(const double &intErrScaling){
+  if (intErrScaling < 0.0) {
+    MPI::throwError("The scaling factor for the accuracy of the integrals can't be negative");
+  }
+  this->intErrScaling = intErrScaling;
+}
+
 void StlsInput::setMixingParameter(const double &aMix){
   if (aMix < 0.0 || aMix > 1.0) {
     MPI::throwError("The mixing parameter must be a number between zero and one");
@@ -194,6 +201,7 @@ void StlsInput::print() const {
   cout << "Iet mapping scheme = " << IETMapping << endl;
   cout << "Maximum number of iterations = " << nIter << endl;
   cout << "Minimum error for convergence = " << errMin << endl;
+  cout << "Scaling factor for the accuracy of the integrals = " << intErrScaling << endl;
   cout << "Mixing parameter = " << aMix << endl;
   cout << "Output frequency = " << outIter << endl;
   cout << "File with recovery data = " << recoveryFileName << endl;
@@ -203,6 +211,7 @@ bool StlsInput::isEqual(const StlsInput &in) const {
   return ( Input::isEqual(in) &&
 	   aMix == in.aMix && 
 	   errMin == in.errMin &&
+	   intErrScaling == in.intErrScaling &&
 	   IETMapping == in.IETMapping &&
 	   nIter == in.nIter &&
 	   outIter == in.outIter &&
@@ -222,6 +231,28 @@ void QstlsInput::setFixedIet(const string &fixedIet){
   this->fixedIet = fixedIet;
 } 
 
+void QstlsInput::setFixedPrecision(const string &fixedPrecision){
+  const vector<string> precisions = {"double", "single"};
+  if (count(precisions.begin(), precisions.end(), fixedPrecision) == 0) {
+    MPI::throwError("Unknown precision for the fixed component: " + fixedPrecision);
+  }
+  this->fixedPrecision = fixedPrecision;
+}
+
+void QstlsInput::setFixedLowRankError(const double &fixedRankErr){
+  if (fixedRankErr < 0.0) {
+    MPI::throwError("The error of the low-rank fixed component can't be negative");
+  }
+  this->fixedRankErr = fixedRankErr;
+}
+
+void QstlsInput::setProgressInterval(const double &progressInterval){
+  if (progressInterval < 0.0) {
+    MPI::throwError("The interval for the progress reports can't be negative");
+  }
+  this->progressInterval = progressInterval;
+}
+
 void QstlsInput::setGuess(const QstlsGuess &guess){
   if (guess.wvg.size() < 3 || guess.ssf.size() < 3) {
     MPI::throwError("The initial guess does not contain enough points");
@@ -246,12 +277,18 @@ void QstlsInput::print() const {
   StlsInput::print();
   cout << "File with fixed adr component = " << fixed  << endl;
   cout << "File with fixed adr component (iet) = " << fixedIet  << endl;
+  cout << "Precision of the fixed adr component = " << fixedPrecision  << endl;
+  cout << "Error of the low-rank fixed adr component = " << fixedRankErr  << endl;
+  cout << "Interval for the progress reports (s) = " << progressInterval  << endl;
 }
 
 bool QstlsInput::isEqual(const QstlsInput &in) const {
   return (StlsInput::isEqual(in) &&
 	  fixed == in.fixed &&
 	  fixedIet == in.fixedIet &&
+	  fixedPrecision == in.fixedPrecision &&
+	  fixedRankErr == in.fixedRankErr &&
+	  progressInterval == in.progressInterval &&
 	  guess == in.guess );
 }
 
@@ -273,6 +310,13 @@ void VSInput::setDegeneracyResolution(const double &dTheta) {
   this->dTheta = dTheta;
 }
 
+void VSInput::setFreeEnergyCouplingResolution(const double &drsFxc) {
+  if (drsFxc < 0) {
+    MPI::throwError("The coupling parameter resolution for the free energy can't be negative");
+  }
+  this->drsFxc = drsFxc;
+}
+
 void VSInput::setAlphaGuess(const vector<double>  &alphaGuess) {
   if (alphaGuess.size() != 2 || alphaGuess[0] >= alphaGuess[1]) {
     MPI::throwError("Invalid guess for free parameter calculation");
@@ -295,6 +339,13 @@ void VSInput::setNIterAlpha(const int &nIterAlpha){
   this->nIterAlpha = nIterAlpha; 
 }
 
+void VSInput::setAlphaGroups(const int &nAlphaGroups){
+  if (nAlphaGroups <= 0) {
+    MPI::throwError("The number of groups for the free parameter must be larger than zero");
+  }
+  this->nAlphaGroups = nAlphaGroups;
+}
+
 void VSInput::setFreeEnergyIntegrand(const FreeEnergyIntegrand& fxcIntegrand) {
   if (fxcIntegrand.integrand.size() < 3) {
     MPI::throwError("The free energy integrand does not contain enough temperature points");
@@ -320,16 +371,20 @@ void VSInput::print() const {
   cout << "Guess for the free parameter = " << alphaGuess.at(0) << "," << alphaGuess.at(1) << endl;
   cout << "Resolution for the coupling parameter grid = " << drs << endl;
   cout << "Resolution for the degeneracy parameter grid = " << dTheta << endl;
+  cout << "Resolution for the free energy coupling parameter grid = " << drsFxc << endl;
   cout << "Minimum error for convergence (alpha) = " << errMinAlpha << endl;
   cout << "Maximum number of iterations (alpha) = " << nIterAlpha << endl;
+  cout << "Number of groups of ranks (alpha) = " << nAlphaGroups << endl;
 }
 
 bool VSInput::isEqual(const VSInput &in) const {
   return ( alphaGuess == in.alphaGuess &&
 	   drs == in.drs &&
 	   dTheta == in.dTheta &&
+	   drsFxc == in.drsFxc &&
 	   errMinAlpha == in.errMinAlpha &&
 	   nIterAlpha == in.nIterAlpha &&
+	   nAlphaGroups == in.nAlphaGroups &&
 	   fxcIntegrand == in.fxcIntegrand);
 }
 
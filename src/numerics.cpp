@@ -1,11 +1,14 @@
 #include <iostream>
 #include <cassert>
+#include <numeric>
 #include "util.hpp"
 #include "numerics.hpp"
 
 using namespace std;
 using namespace GslWrappers;
 using namespace parallelUtil;
+using vecUtil::MatrixView;
+using vecUtil::Vector2D;
 
 // -----------------------------------------------------------------
 // C++ wrappers to GSL objects
@@ -88,50 +91,137 @@ double Interpolator1D::eval(const double& x) const {
 // Interpolator2D class
 // -----------------------------------------------------------------
 
+// First derivatives at the nodes of the natural cubic spline that
+// interpolates (x[i], y[i])
+static void getSplineDerivatives(const vector<double> &x,
+				 const vector<double> &y,
+				 vector<double> &dy) {
+  const size_t n = x.size();
+  // Second derivatives (divided by two) from the tridiagonal system
+  vector<double> c(n, 0.0);
+  vector<double> diag(n, 1.0);
+  vector<double> rhs(n, 0.0);
+  for (size_t i = 1; i < n - 1; ++i) {
+    const double h0 = x[i] - x[i-1];
+    const double h1 = x[i+1] - x[i];
+    diag[i] = 2.0 * (h0 + h1);
+    rhs[i] = 3.0 * ((y[i+1] - y[i]) / h1 - (y[i] - y[i-1]) / h0);
+    if (i > 1) {
+      const double w = h0 / diag[i-1];
+      diag[i] -= w * h0;
+      rhs[i] -= w * rhs[i-1];
+    }
+  }
+  for (size_t i = n - 2; i > 0; --i) {
+    c[i] = (rhs[i] - (x[i+1] - x[i]) * c[i+1]) / diag[i];
+  }
+  dy.resize(n);
+  for (size_t i = 0; i < n - 1; ++i) {
+    const double h = x[i+1] - x[i];
+    dy[i] = (y[i+1] - y[i]) / h - h * (c[i+1] + 2.0 * c[i]) / 3.0;
+  }
+  const double h = x[n-1] - x[n-2];
+  dy[n-1] = (y[n-1] - y[n-2]) / h + h * (2.0 * c[n-1] + c[n-2]) / 3.0;
+}
+
+// Step of a uniform grid (zero if the grid is not uniform)
+static double getGridStep(const vector<double> &grid) {
+  const size_t n = grid.size();
+  const double step = (grid.back() - grid.front()) / (n - 1);
+  for (size_t i = 0; i < n; ++i) {
+    if (abs(grid[i] - grid.front() - i * step) > 1e-6 * step) { return 0.0; }
+  }
+  return step;
+}
+
 // Constructors    
 Interpolator2D::Interpolator2D(const double &x,
 			       const double &y,
 			       const double &z,
 			       const int nx_,
 			       const int ny_) {
-  setup(x, y, z, nx_, ny_);
+  setup(x, y, MatrixView(&z, nx_, ny_));
 }
 
-Interpolator2D::Interpolator2D() {
-  nx = 0;
-  ny = 0;
-  spline = nullptr;
-  xacc = nullptr;
-  yacc = nullptr;
-}
-
-// Destructor
-Interpolator2D::~Interpolator2D(){
-  gsl_spline2d_free(spline);
-  gsl_interp_accel_free(xacc);
-  gsl_interp_accel_free(yacc);
+Interpolator2D::Interpolator2D(const double &x,
+			       const double &y,
+			       const MatrixView &z) {
+  setup(x, y, z);
 }
 
 // Setup interpolator
 void Interpolator2D::setup(const double &x,
 			   const double &y,
-			   const double &z,
-			   const int nx_,
-			   const int ny_) {
-  nx = nx_;
-  ny = ny_;
-  callGSLAlloc(spline, gsl_spline2d_alloc, gsl_interp2d_bicubic, nx, ny);
-  callGSLAlloc(xacc, gsl_interp_accel_alloc);
-  callGSLAlloc(yacc, gsl_interp_accel_alloc);
-  // Ensure that z is stored in the correct order
-  double *za = (double*)malloc(nx * ny * sizeof(double));
+			   const MatrixView &z) {
+  const size_t nx = z.size(0);
+  const size_t ny = z.size(1);
+  if (nx < 2 || ny < 2) {
+    MPI::throwError("The 2D interpolation requires at least two points"
+		    " in each direction");
+  }
+  xGrid.assign(&x, &x + nx);
+  yGrid.assign(&y, &y + ny);
+  xStep = getGridStep(xGrid);
+  yStep = getGridStep(yGrid);
+  // Derivatives at the grid points
+  Vector2D zx(nx, ny);
+  Vector2D zy(nx, ny);
+  Vector2D zxy(nx, ny);
+  vector<double> f;
+  vector<double> df;
+  f.resize(nx);
+  for (size_t j = 0; j < ny; ++j) {
+    for (size_t i = 0; i < nx; ++i) { f[i] = z(i, j); }
+    getSplineDerivatives(xGrid, f, df);
+    for (size_t i = 0; i < nx; ++i) { zx(i, j) = df[i]; }
+  }
+  f.resize(ny);
   for (size_t i = 0; i < nx; ++i) {
-    for (size_t j = 0; j < ny; ++j) {
-      callGSLFunction(gsl_spline2d_set, spline, za, i, j, *(&z + j + i*ny));
+    for (size_t j = 0; j < ny; ++j) { f[j] = z(i, j); }
+    getSplineDerivatives(yGrid, f, df);
+    for (size_t j = 0; j < ny; ++j) { zy(i, j) = df[j]; }
+  }
+  f.resize(nx);
+  for (size_t j = 0; j < ny; ++j) {
+    for (size_t i = 0; i < nx; ++i) { f[i] = zy(i, j); }
+    getSplineDerivatives(xGrid, f, df);
+    for (size_t i = 0; i < nx; ++i) { zxy(i, j) = df[i]; }
+  }
+  // Coefficients of the polynomials sum_kl a_kl t^k u^l in each cell
+  // (a = m * f * m^T, with f the values and the derivatives at the
+  // corners of the cell and m the coefficients of the cubic Hermite
+  // basis functions)
+  static const double m[4][4] = {{ 1.0,  0.0,  0.0,  0.0},
+				 { 0.0,  0.0,  1.0,  0.0},
+				 {-3.0,  3.0, -2.0, -1.0},
+				 { 2.0, -2.0,  1.0,  1.0}};
+  coeff.resize(16 * (nx - 1) * (ny - 1));
+  for (size_t i = 0; i < nx - 1; ++i) {
+    const double hx = xGrid[i+1] - xGrid[i];
+    for (size_t j = 0; j < ny - 1; ++j) {
+      const double hy = yGrid[j+1] - yGrid[j];
+      const double hxy = hx * hy;
+      const double fc[4][4] =
+	{{z(i, j), z(i, j+1), hy * zy(i, j), hy * zy(i, j+1)},
+	 {z(i+1, j), z(i+1, j+1), hy * zy(i+1, j), hy * zy(i+1, j+1)},
+	 {hx * zx(i, j), hx * zx(i, j+1), hxy * zxy(i, j), hxy * zxy(i, j+1)},
+	 {hx * zx(i+1, j), hx * zx(i+1, j+1), hxy * zxy(i+1, j), hxy * zxy(i+1, j+1)}};
+      double mf[4][4];
+      for (int k = 0; k < 4; ++k) {
+	for (int n = 0; n < 4; ++n) {
+	  mf[k][n] = 0.0;
+	  for (int p = 0; p < 4; ++p) { mf[k][n] += m[k][p] * fc[p][n]; }
+	}
+      }
+      double* a = &coeff[16 * (j + i * (ny - 1))];
+      for (int k = 0; k < 4; ++k) {
+	for (int l = 0; l < 4; ++l) {
+	  a[4 * k + l] = 0.0;
+	  for (int n = 0; n < 4; ++n) { a[4 * k + l] += mf[k][n] * m[l][n]; }
+	}
+      }
     }
   }
-  callGSLFunction(gsl_spline2d_init, spline, &x, &y, za, nx, ny);
-  free(za);
 }
 
 // Reset existing interpolator
@@ -140,19 +230,69 @@ void Interpolator2D::reset(const double &x,
 			   const double &z,
 			   const int nx_,
 			   const int ny_) {
-  if (spline) gsl_spline2d_free(spline);
-  if (xacc) gsl_interp_accel_free(xacc);
-  if (yacc) gsl_interp_accel_free(yacc);
-  setup(x, y, z, nx_, ny_);
+  setup(x, y, MatrixView(&z, nx_, ny_));
+}
+
+void Interpolator2D::reset(const double &x,
+			   const double &y,
+			   const MatrixView &z) {
+  setup(x, y, z);
+}
+
+// Index of the cell that contains v
+size_t Interpolator2D::getCell(const vector<double> &grid,
+			       const double &step,
+			       const double &v) {
+  const size_t n = grid.size();
+  if (!(v >= grid.front() && v <= grid.back())) {
+    MPI::throwError("The 2D interpolation point is outside of the grid");
+  }
+  if (step > 0.0) {
+    size_t i = min(static_cast<size_t>((v - grid.front()) / step), n - 2);
+    // Correct for the round-off in the grid
+    if (v < grid[i]) { --i; }
+    else if (v > grid[i+1] && i < n - 2) { ++i; }
+    return i;
+  }
+  const size_t i = distance(grid.begin(), upper_bound(grid.begin(), grid.end(), v));
+  return min(i, n - 1) - 1;
 }
 
 // Evaluate interpolation
+double Interpolator2D::eval(const size_t i,
+			    const double &t,
+			    const size_t j,
+			    const double &u) const {
+  const double* a = &coeff[16 * (j + i * (yGrid.size() - 1))];
+  double out = 0.0;
+  for (int k = 3; k >= 0; --k) {
+    const double* ak = a + 4 * k;
+    out = out * t + (((ak[3] * u + ak[2]) * u + ak[1]) * u + ak[0]);
+  }
+  return out;
+}
+
 double Interpolator2D::eval(const double& x,
 			    const double& y) const {
-  double out;
-  callGSLFunction(gsl_spline2d_eval_e, spline, x, y, xacc, yacc, &out);
-  return out;
-};
+  const size_t i = getCell(xGrid, xStep, x);
+  const size_t j = getCell(yGrid, yStep, y);
+  const double t = (x - xGrid[i]) / (xGrid[i+1] - xGrid[i]);
+  const double u = (y - yGrid[j]) / (yGrid[j+1] - yGrid[j]);
+  return eval(i, t, j, u);
+}
+
+void Interpolator2D::eval(const double& x,
+			  const vector<double>& y,
+			  vector<double>& out) const {
+  const size_t i = getCell(xGrid, xStep, x);
+  const double t = (x - xGrid[i]) / (xGrid[i+1] - xGrid[i]);
+  out.resize(y.size());
+  for (size_t k = 0; k < y.size(); ++k) {
+    const size_t j = getCell(yGrid, yStep, y[k]);
+    const double u = (y[k] - yGrid[j]) / (yGrid[j+1] - yGrid[j]);
+    out[k] = eval(i, t, j, u);
+  }
+}
 
 // -----------------------------------------------------------------
 // BrentRootSolver class
@@ -355,6 +495,136 @@ void Integrator1D::QAGS::compute(const function<double(double)>& func,
 		  &sol, &err);
 }
 
+// -----------------------------------------------------------------
+// GaussLegendre class
+// -----------------------------------------------------------------
+
+// Constructor
+GaussLegendre::GaussLegendre(const size_t n) : nodes(n), weights(n) {
+  gsl_integration_glfixed_table *table;
+  callGSLAlloc(table, gsl_integration_glfixed_table_alloc, n);
+  for (size_t i = 0; i < n; ++i) {
+    gsl_integration_glfixed_point(-1.0, 1.0, i, &nodes[i], &weights[i], table);
+  }
+  gsl_integration_glfixed_table_free(table);
+}
+
+// Map nodes and weights to the interval [a, b]
+void GaussLegendre::map(const double& a,
+			const double& b,
+			vector<double>& x,
+			vector<double>& w) const {
+  const double center = 0.5 * (a + b);
+  const double halfWidth = 0.5 * (b - a);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    x.push_back(center + halfWidth * nodes[i]);
+    w.push_back(halfWidth * weights[i]);
+  }
+}
+
+// -----------------------------------------------------------------
+// SplineFunctional class
+// -----------------------------------------------------------------
+
+// Constructors
+SplineFunctional::SplineFunctional(const vector<double>& x) {
+  const size_t nIntervals = (x.size() > 0) ? x.size() - 1 : 0;
+  vector<double> moments(4 * nIntervals);
+  for (size_t i = 0; i < nIntervals; ++i) {
+    const double h = x[i + 1] - x[i];
+    double hm = h;
+    for (size_t m = 0; m < 4; ++m) {
+      moments[4 * i + m] = hm / (m + 1);
+      hm *= h;
+    }
+  }
+  setup(x, moments);
+}
+
+SplineFunctional::SplineFunctional(const vector<double>& x,
+				   const Func& kernel,
+				   const size_t nNodes) {
+  const size_t nIntervals = (x.size() > 0) ? x.size() - 1 : 0;
+  const GaussLegendre gl(nNodes);
+  vector<double> moments(4 * nIntervals);
+  vector<double> nodes;
+  vector<double> nodeWeights;
+  for (size_t i = 0; i < nIntervals; ++i) {
+    nodes.clear();
+    nodeWeights.clear();
+    gl.map(x[i], x[i + 1], nodes, nodeWeights);
+    for (size_t j = 0; j < nodes.size(); ++j) {
+      const double u = nodes[j] - x[i];
+      double f = nodeWeights[j] * kernel(nodes[j]);
+      for (size_t m = 0; m < 4; ++m) {
+	moments[4 * i + m] += f;
+	f *= u;
+      }
+    }
+  }
+  setup(x, moments);
+}
+
+// Compute the weights. On the interval i the spline can be written as
+// s(x_i + u) = y_i + b_i u + M_i u^2 / 2 + (M_{i+1} - M_i) u^3 / (6 h_i),
+// where the second derivatives M solve the tridiagonal system that
+// defines the natural spline (A M = B y with M_0 = M_{n-1} = 0). The
+// contribution of M to the functional is mapped back to the data by
+// solving the (symmetric) system A z = wM and adding B^T z
+void SplineFunctional::setup(const vector<double>& x,
+			     const vector<double>& moments) {
+  const size_t n = x.size();
+  weights.assign(n, 0.0);
+  if (n < 2) { return; }
+  vector<double> h(n - 1);
+  for (size_t i = 0; i < n - 1; ++i) { h[i] = x[i + 1] - x[i]; }
+  // Weights for the data and for the second derivatives
+  vector<double> wM(n, 0.0);
+  for (size_t i = 0; i < n - 1; ++i) {
+    const double* mu = &moments[4 * i];
+    weights[i] += mu[0] - mu[1] / h[i];
+    weights[i + 1] += mu[1] / h[i];
+    wM[i] += - mu[1] * h[i] / 3.0 + mu[2] / 2.0 - mu[3] / (6.0 * h[i]);
+    wM[i + 1] += - mu[1] * h[i] / 6.0 + mu[3] / (6.0 * h[i]);
+  }
+  if (n < 3) { return; }
+  // Solve A z = wM for the interior points (Thomas algorithm)
+  const size_t nInt = n - 2;
+  vector<double> diag(nInt);
+  vector<double> z(nInt);
+  for (size_t j = 0; j < nInt; ++j) {
+    diag[j] = 2.0 * (h[j] + h[j + 1]);
+    z[j] = wM[j + 1];
+    if (j > 0) {
+      const double factor = h[j] / diag[j - 1];
+      diag[j] -= factor * h[j];
+      z[j] -= factor * z[j - 1];
+    }
+  }
+  z[nInt - 1] /= diag[nInt - 1];
+  for (size_t j = nInt - 1; j-- > 0;) {
+    z[j] = (z[j] - h[j + 1] * z[j + 1]) / diag[j];
+  }
+  // Add B^T z
+  for (size_t j = 0; j < nInt; ++j) {
+    const size_t k = j + 1;
+    weights[k - 1] += 6.0 * z[j] / h[k - 1];
+    weights[k] -= 6.0 * z[j] * (1.0 / h[k] + 1.0 / h[k - 1]);
+    weights[k + 1] += 6.0 * z[j] / h[k];
+  }
+}
+
+// Evaluate the functional
+double SplineFunctional::eval(const vector<double>& y,
+			      const double& offset) const {
+  assert(y.size() == weights.size());
+  double out = 0.0;
+  for (size_t i = 0; i < weights.size(); ++i) {
+    out += weights[i] * (y[i] - offset);
+  }
+  return out;
+}
+
 // -----------------------------------------------------------------
 // Integrator2D class
 // -----------------------------------------------------------------
@@ -397,3 +667,276 @@ void Integrator2D::compute(const function<double(double)>& func1,
   itg1.compute(func, param);
   sol = itg1.getSolution();
 }
+
+// -----------------------------------------------------------------
+// VectorIntegrator1D class
+// -----------------------------------------------------------------
+
+// Apply the Gauss-Kronrod rule to the interval i. The integrand is
+// evaluated once at each node and the rule is then applied to each
+// component separately. As in the other integrators, the integrand is
+// allowed to be singular at isolated points (the nodes where the
+// integrand is not finite are dropped)
+void VectorIntegrator1D::applyRule(const Func& func,
+				   const size_t i) {
+  nodes.clear();
+  values.clear();
+  vector<double> f(n);
+  size_t k = 0;
+  auto eval = [&](const double& x)->double {
+    const auto it = find(nodes.begin(), nodes.end(), x);
+    if (it != nodes.end()) { return values[(it - nodes.begin()) * n + k]; }
+    func(x, f);
+    for (auto& fk : f) { if (!isfinite(fk)) { fk = 0.0; } }
+    nodes.push_back(x);
+    values.insert(values.end(), f.begin(), f.end());
+    return f[k];
+  };
+  GslFunctionWrap<decltype(eval)> Fp(eval);
+  for (k = 0; k < n; ++k) {
+    double resasc;
+    gsl_integration_qk21(&Fp, a[i], b[i], &intervalSol[i * n + k],
+			 &intervalErr[i * n + k], &intervalAbs[i * n + k],
+			 &resasc);
+  }
+}
+
+// Compute integral
+void VectorIntegrator1D::compute(const Func& func,
+				 const Integrator1D::Param& param,
+				 const size_t n_) {
+  // Check parameter validity
+  if (isnan(param.xMin) || isnan(param.xMax)) {
+    MPI::throwError("Integration limits were not set correctly");
+  }
+  // The buffers are kept between successive calls to avoid repeated
+  // memory allocations
+  n = n_;
+  a.assign(1, param.xMin);
+  b.assign(1, param.xMax);
+  intervalSol.resize(n);
+  intervalErr.resize(n);
+  intervalAbs.resize(n);
+  applyRule(func, 0);
+  sol.assign(intervalSol.begin(), intervalSol.begin() + n);
+  vector<double> err(intervalErr.begin(), intervalErr.begin() + n);
+  vector<double> solAbs(intervalAbs.begin(), intervalAbs.begin() + n);
+  vector<double> tol(n);
+  // The accuracy is measured relative to the integral of the absolute
+  // value of each component. This avoids refining without end the
+  // components that are the result of strong cancellations
+  while (true) {
+    bool converged = true;
+    for (size_t k = 0; k < n; ++k) {
+      tol[k] = relErr * solAbs[k];
+      if (err[k] > tol[k]) { converged = false; }
+    }
+    if (converged) { break; }
+    // Find the interval that gives the largest contribution to the
+    // error of the components that have not converged yet
+    double maxRatio = 0.0;
+    size_t iMax = 0;
+    const size_t nIntervals = a.size();
+    for (size_t i = 0; i < nIntervals; ++i) {
+      for (size_t k = 0; k < n; ++k) {
+	if (err[k] <= tol[k]) { continue; }
+	const double ratio = intervalErr[i * n + k] / tol[k];
+	if (ratio > maxRatio) {
+	  maxRatio = ratio;
+	  iMax = i;
+	}
+      }
+    }
+    // Bisect the interval. As for the CQUAD integrator used for the
+    // scalar functions, the best estimate is returned if the accuracy
+    // cannot be reached (e.g. for components that are affected by the
+    // round-off errors of the inner integrals)
+    const double mid = 0.5 * (a[iMax] + b[iMax]);
+    if (mid <= a[iMax] || mid >= b[iMax] || nIntervals >= limit) { break; }
+    for (size_t k = 0; k < n; ++k) {
+      sol[k] -= intervalSol[iMax * n + k];
+      err[k] -= intervalErr[iMax * n + k];
+      solAbs[k] -= intervalAbs[iMax * n + k];
+    }
+    a.push_back(mid);
+    b.push_back(b[iMax]);
+    b[iMax] = mid;
+    intervalSol.resize(a.size() * n);
+    intervalErr.resize(a.size() * n);
+    intervalAbs.resize(a.size() * n);
+    for (const size_t i : {iMax, nIntervals}) {
+      applyRule(func, i);
+      for (size_t k = 0; k < n; ++k) {
+	sol[k] += intervalSol[i * n + k];
+	err[k] += intervalErr[i * n + k];
+	solAbs[k] += intervalAbs[i * n + k];
+      }
+    }
+  }
+  // Sum the contributions of all the intervals to reduce the
+  // accumulation of round-off errors
+  fill(sol.begin(), sol.end(), 0.0);
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (size_t k = 0; k < n; ++k) { sol[k] += intervalSol[i * n + k]; }
+  }
+}
+
+// -----------------------------------------------------------------
+// VectorIntegrator2D class
+// -----------------------------------------------------------------
+
+// Compute integral
+void VectorIntegrator2D::compute(const Func& func1,
+				 const Func& func2,
+				 const Param& param,
+				 const vector<double>& xGrid,
+				 const size_t n1,
+				 const size_t n2) {
+  assert(n2 == 1 || n2 == n1);
+  const int nx = xGrid.size();
+  Func func;
+  vector<vector<double>> sol2;
+  vector<Interpolator1D> itp;
+  auto getParam1D = [&](const double& x) {
+    return Integrator1D::Param(param.yMin(x), param.yMax(x));
+  };
+  if (nx > 0) {
+    // Level 2 integration (only evaluated at the points in xGrid)
+    sol2.assign(n2, vector<double>(nx));
+    for (int i = 0; i < nx; ++i) {
+      x = xGrid[i];
+      itg2.compute(func2, getParam1D(x), n2);
+      const vector<double>& sol = itg2.getSolution();
+      for (size_t k = 0; k < n2; ++k) { sol2[k][i] = sol[k]; }
+    }
+    itp.resize(n2);
+    for (size_t k = 0; k < n2; ++k) { itp[k].reset(xGrid[0], sol2[k][0], nx); }
+    func = [&](const double& x_, vector<double>& res)->void {
+      func1(x_, res);
+      for (size_t k = 0; k < n1; ++k) { res[k] *= itp[k % n2].eval(x_); }
+    };
+  }
+  else {
+    // Level 2 integration (evaluated at arbitrary points)
+    func = [&](const double& x_, vector<double>& res)->void {
+      x = x_;
+      func1(x_, res);
+      itg2.compute(func2, getParam1D(x), n2);
+      const vector<double>& sol = itg2.getSolution();
+      for (size_t k = 0; k < n1; ++k) { res[k] *= sol[k % n2]; }
+    };
+  }
+  // Level 1 integration
+  itg1.compute(func, param, n1);
+}
+
+// -----------------------------------------------------------------
+// LowRankMatrix class
+// -----------------------------------------------------------------
+
+LowRankMatrix::LowRankMatrix(const MatrixView& a,
+			     const double& relErr)
+  : n1(a.size(0)), n2(a.size(1)), rank(0) {
+  constexpr int maxSweeps = 50;
+  constexpr double eps = 1e-15;
+  // Rows scaled to unit maximum, so that the error of each row
+  // relative to its maximum is the error of the scaled matrix
+  vector<double> scale(n1, 0.0);
+  vector<double> b(n1 * n2);
+  a.copyTo(b.data());
+  for (size_t i = 0; i < n1; ++i) {
+    double* row = b.data() + i * n2;
+    for (size_t j = 0; j < n2; ++j) { scale[i] = max(scale[i], abs(row[j])); }
+    if (scale[i] > 0.0) {
+      for (size_t j = 0; j < n2; ++j) { row[j] /= scale[i]; }
+    }
+  }
+  const vector<double> bScaled = b;
+  // One-sided Jacobi: the rows of b are made orthogonal with plane
+  // rotations that are accumulated in w. At convergence b = w^T a
+  // (scaled), so that a = sum_k w_k b_k^T with w_k the k-th row of w
+  vector<double> w(n1 * n1, 0.0);
+  for (size_t i = 0; i < n1; ++i) { w[i * n1 + i] = 1.0; }
+  auto rotate = [](double* x, double* y, const size_t n,
+		   const double& c, const double& s)->void{
+    for (size_t j = 0; j < n; ++j) {
+      const double xj = x[j];
+      x[j] = c * xj - s * y[j];
+      y[j] = s * xj + c * y[j];
+    }
+  };
+  for (int sweep = 0; sweep < maxSweeps; ++sweep) {
+    bool rotated = false;
+    for (size_t p = 0; p + 1 < n1; ++p) {
+      double* bp = b.data() + p * n2;
+      for (size_t q = p + 1; q < n1; ++q) {
+	double* bq = b.data() + q * n2;
+	const double alpha = inner_product(bp, bp + n2, bp, 0.0);
+	const double beta = inner_product(bq, bq + n2, bq, 0.0);
+	const double gamma = inner_product(bp, bp + n2, bq, 0.0);
+	if (abs(gamma) <= eps * sqrt(alpha * beta)) { continue; }
+	const double zeta = (beta - alpha) / (2.0 * gamma);
+	const double t = ((zeta >= 0.0) ? 1.0 : -1.0)
+	  / (abs(zeta) + sqrt(1.0 + zeta * zeta));
+	const double c = 1.0 / sqrt(1.0 + t * t);
+	rotate(bp, bq, n2, c, c * t);
+	rotate(w.data() + p * n1, w.data() + q * n1, n1, c, c * t);
+	rotated = true;
+      }
+    }
+    if (!rotated) { break; }
+  }
+  // Terms sorted by decreasing singular value
+  vector<double> sigma(n1);
+  for (size_t k = 0; k < n1; ++k) {
+    const double* bk = b.data() + k * n2;
+    sigma[k] = sqrt(inner_product(bk, bk + n2, bk, 0.0));
+  }
+  vector<size_t> order(n1);
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&](const size_t& k1, const size_t& k2){
+    return sigma[k1] > sigma[k2];
+  });
+  // Add terms until the error of all the rows is within tolerance
+  vector<double> res = bScaled;
+  for (const size_t& k : order) {
+    const double resMax = accumulate(res.begin(), res.end(), 0.0,
+				     [](const double& m, const double& el){
+				       return max(m, abs(el));
+				     });
+    if (resMax <= relErr || sigma[k] == 0.0) { break; }
+    const double* bk = b.data() + k * n2;
+    const double* wk = w.data() + k * n1;
+    for (size_t i = 0; i < n1; ++i) {
+      double* row = res.data() + i * n2;
+      for (size_t j = 0; j < n2; ++j) { row[j] -= wk[i] * bk[j]; }
+    }
+    for (size_t i = 0; i < n1; ++i) { u.push_back(wk[i] * sigma[k] * scale[i]); }
+    for (size_t j = 0; j < n2; ++j) { v.push_back(bk[j] / sigma[k]); }
+    ++rank;
+  }
+}
+
+LowRankMatrix::LowRankMatrix(const size_t n1_,
+			     const size_t n2_,
+			     const vector<double>& u_,
+			     const vector<double>& v_) : n1(n1_), n2(n2_),
+							 rank(0), u(u_), v(v_) {
+  if (n1 == 0 || n2 == 0 || u.size() % n1 != 0
+      || v.size() % n2 != 0 || u.size() / n1 != v.size() / n2) {
+    MPI::throwError("Inconsistent low-rank matrix");
+  }
+  rank = u.size() / n1;
+}
+
+void LowRankMatrix::get(double* a) const {
+  fill(a, a + n1 * n2, 0.0);
+  for (size_t k = 0; k < rank; ++k) {
+    const double* uk = getU(k);
+    const double* vk = getV(k);
+    for (size_t i = 0; i < n1; ++i) {
+      double* row = a + i * n2;
+      for (size_t j = 0; j < n2; ++j) { row[j] += uk[i] * vk[j]; }
+    }
+  }
+}
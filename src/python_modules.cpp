@@ -3,6 +3,7 @@
 #include "util.hpp"
 #include "input.hpp"
 #include "numerics.hpp"
+#include "resource_plan.hpp"
 #include "python_wrappers.hpp"
 
 namespace bp = boost::python;
@@ -91,6 +92,9 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("error",
 		  &StlsInput::getErrMin,
 		  &StlsInput::setErrMin)
+    .add_property("errorIntegralsScaling",
+		  &StlsInput::getIntErrorScaling,
+		  &StlsInput::setIntErrorScaling)
     .add_property("mixing",
 		  &StlsInput::getMixingParameter,
 		  &StlsInput::setMixingParameter)
@@ -129,6 +133,9 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("iterationsAlpha",
 		  &VSStlsInput::getNIterAlpha,
 		  &VSStlsInput::setNIterAlpha)
+    .add_property("groupsAlpha",
+		  &VSStlsInput::getAlphaGroups,
+		  &VSStlsInput::setAlphaGroups)
     .add_property("alpha",
 		  &PyVSStlsInput::getAlphaGuess,
 		  &PyVSStlsInput::setAlphaGuess)
@@ -138,6 +145,9 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("degeneracyResolution",
 		  &VSStlsInput::getDegeneracyResolution,
 		  &VSStlsInput::setDegeneracyResolution)
+    .add_property("freeEnergyCouplingResolution",
+		  &VSStlsInput::getFreeEnergyCouplingResolution,
+		  &VSStlsInput::setFreeEnergyCouplingResolution)
     .add_property("freeEnergyIntegrand",
 		  &VSStlsInput::getFreeEnergyIntegrand,
 		  &VSStlsInput::setFreeEnergyIntegrand)
@@ -170,6 +180,15 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("fixediet",
 		  &QstlsInput::getFixedIet,
 		  &QstlsInput::setFixedIet)
+    .add_property("fixedPrecision",
+		  &QstlsInput::getFixedPrecision,
+		  &QstlsInput::setFixedPrecision)
+    .add_property("fixedLowRankError",
+		  &QstlsInput::getFixedLowRankError,
+		  &QstlsInput::setFixedLowRankError)
+    .add_property("progressInterval",
+		  &QstlsInput::getProgressInterval,
+		  &QstlsInput::setProgressInterval)
     .def("print", &QstlsInput::print)
     .def("isEqual", &QstlsInput::isEqual);
 
@@ -181,6 +200,9 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("iterationsAlpha",
 		  &QVSStlsInput::getNIterAlpha,
 		  &QVSStlsInput::setNIterAlpha)
+    .add_property("groupsAlpha",
+		  &QVSStlsInput::getAlphaGroups,
+		  &QVSStlsInput::setAlphaGroups)
     .add_property("alpha",
 		  &PyQVSStlsInput::getAlphaGuess,
 		  &PyQVSStlsInput::setAlphaGuess)
@@ -190,6 +212,9 @@ BOOST_PYTHON_MODULE(qupled)
     .add_property("degeneracyResolution",
 		  &QVSStlsInput::getDegeneracyResolution,
 		  &QVSStlsInput::setDegeneracyResolution)
+    .add_property("freeEnergyCouplingResolution",
+		  &QVSStlsInput::getFreeEnergyCouplingResolution,
+		  &QVSStlsInput::setFreeEnergyCouplingResolution)
     .add_property("freeEnergyIntegrand",
 		  &QVSStlsInput::getFreeEnergyIntegrand,
 		  &QVSStlsInput::setFreeEnergyIntegrand)
@@ -219,6 +244,10 @@ BOOST_PYTHON_MODULE(qupled)
   bp::class_<Stls, bp::bases<Rpa>>("Stls",
 				   bp::init<const StlsInput>())
     .def("compute", &PyStls::compute)
+    .def("init", &PyStls::initialize)
+    .def("step", &PyStls::step)
+    .def("state", &PyStls::getState)
+    .def("setCallback", &PyStls::setCallback)
     .add_property("error", &PyStls::getError)
     .add_property("bf", &PyStls::getBf);
 
@@ -227,6 +256,7 @@ BOOST_PYTHON_MODULE(qupled)
 				     bp::init<const VSStlsInput>())
     .def("compute", &PyVSStls::compute)
     .add_property("error", &PyVSStls::getError)
+    .add_property("alpha", &PyVSStls::getAlpha)
     .add_property("freeEnergyIntegrand", &PyVSStls::getFreeEnergyIntegrand)
     .add_property("freeEnergyGrid", &PyVSStls::getFreeEnergyGrid);
       
@@ -242,6 +272,7 @@ BOOST_PYTHON_MODULE(qupled)
 				      bp::init<const QVSStlsInput>())
     .def("compute", &PyQVSStls::compute)
     .add_property("error", &PyQVSStls::getError)
+    .add_property("alpha", &PyQVSStls::getAlpha)
     .add_property("freeEnergyIntegrand", &PyQVSStls::getFreeEnergyIntegrand)
     .add_property("freeEnergyGrid", &PyQVSStls::getFreeEnergyGrid)
     .add_property("adr", &PyQVSStls::getAdr);
@@ -249,11 +280,35 @@ BOOST_PYTHON_MODULE(qupled)
   // MPI class
   bp::class_<PyMPI>("MPI")
     .def("rank", &PyMPI::rank)
+    .def("numberOfRanks", &PyMPI::numberOfRanks)
     .def("isRoot", &PyMPI::isRoot)
     .def("barrier", &PyMPI::barrier)
-    .def("timer", &PyMPI::timer);
+    .def("timer", &PyMPI::timer)
+    .def("splitCommunicator", &PyMPI::splitCommunicator)
+    .def("freeCommunicator", &PyMPI::freeCommunicator)
+    .def("getCommunicator", &PyMPI::getCommunicator)
+    .def("setCommunicator", &PyMPI::setCommunicator);
   
   
+  // Class to estimate the resources needed to solve a scheme
+  bp::class_<ResourcePlan>("ResourcePlan",
+			   bp::init<const RpaInput&>())
+    .def(bp::init<const QstlsInput&>())
+    .def(bp::init<const VSStlsInput&>())
+    .def(bp::init<const QVSStlsInput&>())
+    .def("setRanks", &ResourcePlan::setRanks)
+    .def("calibrate", &ResourcePlan::calibrate)
+    .def("print", &ResourcePlan::print)
+    .add_property("gridSize", &ResourcePlan::getWaveVectorGridSize)
+    .add_property("memoryPerRank", &ResourcePlan::getMemoryPerRank)
+    .add_property("memoryPerNode", &ResourcePlan::getMemoryPerNode)
+    .add_property("diskFixed", &ResourcePlan::getFixedDiskUsage)
+    .add_property("diskCheckpoints", &ResourcePlan::getCheckpointDiskUsage)
+    .add_property("integralsIdr", &ResourcePlan::getIdrIntegrals)
+    .add_property("integralsFixed", &ResourcePlan::getFixedIntegrals)
+    .add_property("integralsFixedIet", &ResourcePlan::getFixedIetIntegrals)
+    .add_property("runTimeFixed", &ResourcePlan::getFixedRunTime);
+  
   // Post-process methods
   bp::def("computeRdf", &PyThermo::computeRdf);
   bp::def("computeInternalEnergy", &PyThermo::computeInternalEnergy);
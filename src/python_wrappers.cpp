@@ -189,6 +189,35 @@ int PyStls::compute(Stls& stls) {
   return stls.compute();
 }
 
+int PyStls::initialize(Stls& stls) {
+  return stls.initialize();
+}
+
+int PyStls::step(Stls& stls,
+		 const int nIter) {
+  return stls.step(nIter);
+}
+
+bp::dict PyStls::getState(const Stls& stls) {
+  bp::dict state;
+  state["iteration"] = stls.getIteration();
+  state["error"] = stls.getResidual();
+  state["converged"] = stls.isConverged();
+  return state;
+}
+
+void PyStls::setCallback(Stls& stls,
+			 const bp::object& callback) {
+  if (callback.is_none()) {
+    stls.setCallback(nullptr);
+    return;
+  }
+  stls.setCallback([callback](const int iteration, const double error) {
+    const bp::object proceed = callback(iteration, error);
+    return proceed.is_none() || bp::extract<bool>(proceed)();
+  });
+}
+
 double PyStls::getError(const Stls& stls) {
   return stls.getError();
 }
@@ -211,6 +240,10 @@ double PyVSStls::getError(const VSStls &vsstls){
   return -1;
 }
 
+double PyVSStls::getAlpha(const VSStls &vsstls){
+  return vsstls.getAlpha();
+}
+
 bn::ndarray PyVSStls::getFreeEnergyIntegrand(const VSStls &vsstls){
   return vp::toNdArray2D(vsstls.getFreeEnergyIntegrand());
 }
@@ -233,6 +266,10 @@ double PyQVSStls::getError(const QVSStls &qvsstls){
   return -1;
 }
 
+double PyQVSStls::getAlpha(const QVSStls &qvsstls){
+  return qvsstls.getAlpha();
+}
+
 bn::ndarray PyQVSStls::getAdr(const QVSStls& qvsstls) {
   return vp::toNdArray2D(qvsstls.getAdr());
 }
@@ -1,5 +1,6 @@
 #include <filesystem>
 #include <numeric>
+#include <set>
 #include <fmt/core.h>
 #include "util.hpp"
 #include "numerics.hpp"
@@ -21,31 +22,33 @@ Qstls::Qstls(const QstlsInput& in_,
 	     const bool verbose_,
 	     const bool writeFiles_) : Stls(in_, verbose_, writeFiles_),
 				       in(in_) {
-  // Throw error message for ground state calculations
-  if (in.getDegeneracy() == 0.0) {
-    MPI::throwError("Ground state calculations are not available "
-		    "for the quantum schemes");
-  }
   // Check if iet scheme should be solved
   useIet = in.getTheory() == "QSTLS-HNC" ||
            in.getTheory() == "QSTLS-IOI" ||
            in.getTheory() == "QSTLS-LCT";
+  // Throw error message for ground state calculations
+  if (in.getDegeneracy() == 0.0 && useIet) {
+    MPI::throwError("Ground state calculations are not available "
+		    "for the quantum iet schemes");
+  }
   // Allocate arrays
   const size_t nx = wvg.size();
   const size_t nl = in.getNMatsubara();
   adr.resize(nx, nl);
   ssfNew.resize(nx);
   ssfOld.resize(nx);
-  adrFixed.resize(nx, nl, nx);
   if (useIet) {
     bf.resize(nx);
     adrOld.resize(nx, nl);
   }
+  // Imaginary frequency grid for ground state calculations
+  if (in.getDegeneracy() == 0.0) { buildFreqGrid(); }
   // Deallocate arrays that are inherited but not used
   vector<double>().swap(slfcNew);
 }
 
 int Qstls::compute(){
+  MPI::CommunicatorScope commScope(comm);
   try {
     init();
     if (verbose) cout << "Structural properties calculation ..." << endl;
@@ -61,52 +64,115 @@ int Qstls::compute(){
 
 void Qstls::init(){
   Stls::init();
+  if (in.getDegeneracy() == 0.0) {
+    if (verbose) cout << "Computing ideal density response (imaginary frequencies): ";
+    computeIdrGround();
+    if (verbose) cout << "Done" << endl;
+  }
+  // The communication of the fixed component among the ranks is
+  // completed only after the iet fixed component is computed
+  MPI::GatherRequest adrFixedRequest;
   if (verbose) cout << "Computing fixed component of the auxiliary density response: ";
-  computeAdrFixed();
+  computeAdrFixed(adrFixedRequest);
   if (verbose) cout << "Done" << endl;
   if (useIet) {
     if (verbose) cout << "Computing fixed component of the iet auxiliary density response: ";
     computeAdrFixedIet();
     if (verbose) cout << "Done" << endl;
   }
+  adrFixedRequest.wait();
+  finalizeAdrFixed();
 }
 
+// Steps that follow the calculation of the fixed component (shared
+// with the initialization of the state points of the qVS scheme)
+void Qstls::finalizeAdrFixed() {
+  if (in.getFixed().empty()) {
+    writeAdrFixed();
+    removeAdrFixedCheckpoints();
+  }
+  if (in.getFixedLowRankError() > 0.0) {
+    if (verbose) cout << "Computing low-rank fixed component of the auxiliary density response: ";
+    computeAdrFixedLowRank();
+    if (verbose) cout << "Done" << endl;
+  }
+}
 
-// qstls iterations
-void Qstls::doIterations() {
-  const int maxIter = in.getNIter();
-  const int outIter = in.getOutIter();
-  const double minErr = in.getErrMin();
-  double err = 1.0;
-  int counter = 0;
-  // Define initial guess
-  initialGuess();
-  while (counter < maxIter+1 && err > minErr ) {
-    // Start timing
-    double tic = MPI::timer();
-    // Update auxiliary density response
-    computeAdr();
-    // Update static structure factor
-    computeSsf();
-    // Update diagnostic
-    counter++;
-    err = computeError();
-    // Update solution
-    updateSolution();
-    // Write output
-    if (counter % outIter == 0 && writeFiles) { writeRecovery(); };
-    // End timing
-    double toc = MPI::timer();
-    // Print diagnostic
-    if (verbose) {
-       printf("--- iteration %d ---\n", counter);
-       printf("Elapsed time: %f seconds\n", toc - tic);
-       printf("Residual error: %.5e\n", err);
-       fflush(stdout);
+// Set up the imaginary frequency grid used for ground state
+// calculations. The integral over the frequencies is computed with a
+// Gauss-Legendre rule in t = nu/(s + nu), where s = x^2 + 2x sets the
+// frequency scale for each wave-vector. The first frequency is always
+// zero (with zero weight) and is used for the static local field
+// correction
+void Qstls::buildFreqGrid() {
+  const size_t nx = wvg.size();
+  const size_t nl = in.getNMatsubara();
+  if (nl < 2) {
+    MPI::throwError("Ground state calculations require at least two frequencies");
+  }
+  const GaussLegendre gl(nl - 1);
+  vector<double> t;
+  vector<double> wt;
+  gl.map(0.0, 1.0, t, wt);
+  freq.resize(nx, nl);
+  freqWeights.resize(nx, nl);
+  for (size_t i = 0; i < nx; ++i) {
+    const double x = wvg[i];
+    const double scale = (x > 0.0) ? x * (x + 2.0) : 1.0;
+    for (size_t l = 1; l < nl; ++l) {
+      const double tl = t[l-1];
+      const double dt = 1.0 - tl;
+      freq(i, l) = scale * tl / dt;
+      freqWeights(i, l) = scale * wt[l-1] / (dt * dt);
+    }
+  }
+}
+
+// Compute ideal density response at imaginary frequencies
+void Qstls::computeIdrGround() {
+  const size_t nx = wvg.size();
+  const size_t nl = in.getNMatsubara();
+  assert(idr.size(0) == nx && idr.size(1) == nl);
+  for (size_t i = 0; i < nx; ++i) {
+    for (size_t l = 0; l < nl; ++l) {
+      idr(i, l) = IdrGround(freq(i, l), wvg[i]).imagFreq0();
     }
   }
+}
+
+// Single qstls iteration
+void Qstls::doIteration() {
+  const int outIter = in.getOutIter();
+  // Start timing
+  double tic = MPI::timer();
+  // Set the accuracy of the integrals
+  itgError = getIterationIntError();
+  itg.setAccuracy(itgError);
+  // Update auxiliary density response
+  computeAdr();
+  itg.setAccuracy(in.getIntError());
+  // Update static structure factor
+  computeSsf();
+  // Update diagnostic
+  counter++;
+  residual = computeError();
+  // Update solution
+  updateSolution();
   // Set static structure factor for output
   ssf = ssfOld;
+  // Write output
+  if (counter % outIter == 0 && writeFiles) { writeRecovery(); };
+  // End timing
+  double toc = MPI::timer();
+  // Print diagnostic
+  if (verbose) {
+    printf("--- iteration %d ---\n", counter);
+    printf("Elapsed time: %f seconds\n", toc - tic);
+    printf("Residual error: %.5e\n", residual);
+    fflush(stdout);
+  }
+  // Notify the callback
+  callCallback();
 }
 
 // Initial guess for qstls iterations
@@ -130,23 +196,25 @@ void Qstls::initialGuess() {
     if (checkAdrFixed(wvg_, Theta, nl_) == 0) {
       adrFixed = adrFixed_;
     }
-    return;
   }
   // From guess in input
-  if (in.getGuess().wvg.size() > 0) {
+  else if (in.getGuess().wvg.size() > 0) {
     const auto &guess = in.getGuess();
     initialGuessSsf(guess.wvg, guess.ssf);
     if (useIet) { initialGuessAdr(guess.wvg, guess.adr); }
-    return;
-  }  
+  }
   // Default
-  Rpa rpa(in, false);
-  int status = rpa.compute();
-  if (status != 0) {
-    MPI::throwError("Failed to compute the default initial guess");
+  else {
+    Rpa rpa(in, false);
+    int status = rpa.compute();
+    if (status != 0) {
+      MPI::throwError("Failed to compute the default initial guess");
+    }
+    ssfOld = rpa.getSsf();
+    if (useIet) { adrOld.fill(0.0); }
   }
-  ssfOld = rpa.getSsf();
-  if (useIet) { adrOld.fill(0.0); }
+  // Set static structure factor for output
+  ssf = ssfOld;
 }
 
 void Qstls::initialGuessSsf(const vector<double> &wvg_,
@@ -194,18 +262,37 @@ void Qstls::initialGuessAdr(const vector<double> &wvg_,
 // Compute auxiliary density response
 void Qstls::computeAdr() {
   const int nx = wvg.size();
+  // The iet contribution is computed first so that its communication
+  // among the ranks overlaps with the calculation of the qstls term
+  Vector2D adrIet;
+  MPI::GatherRequest adrIetRequest;
+  if (useIet) computeAdrIet(adrIet, adrIetRequest);
   const Interpolator1D ssfi(wvg, ssfOld);
-  for (int i=0; i<nx; ++i) {
-    Adr adrTmp(in.getDegeneracy(), wvg.front(),
-	       wvg.back(), wvg[i], ssfi, itg);
-    adrTmp.get(wvg, adrFixed, adr);
+  if (!adrFixedLowRank.empty()) {
+    AdrLowRank adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(), ssfi);
+    adrTmp.get(wvg, adrFixedLowRank, adr);
+  }
+  else {
+    for (int i=0; i<nx; ++i) {
+      Adr adrTmp(in.getDegeneracy(), wvg.front(),
+		 wvg.back(), wvg[i], ssfi, itg);
+      adrTmp.get(wvg, adrFixed, adr);
+    }
+  }
+  if (useIet) {
+    // Sum qstls and qstls-iet contributions to adr
+    adrIetRequest.wait();
+    adr.sum(adrIet);
   }
-  if (useIet) computeAdrIet();
   for (int i=0; i<nx; ++i) {slfc[i] = adr(i,0)/idr(i,0); };
 }
 
 // Compute static structure factor
 void Qstls::computeSsf(){
+  if (in.getDegeneracy() == 0.0) {
+    computeSsfGround();
+    return;
+  }
   computeSsfFinite();
 }
 
@@ -228,6 +315,17 @@ void Qstls::computeSsfFinite(){
   }
 }
 
+// Compute static structure factor at zero temperature
+void Qstls::computeSsfGround(){
+  const double rs = in.getCoupling();
+  const int nx = wvg.size();
+  const int nl = idr.size(1);
+  for (int i=0; i<nx; ++i){
+    QssfGround ssfTmp(wvg[i], rs, ssfHF[i], nl, &idr(i), &adr(i), &freqWeights(i));
+    ssfNew[i] = ssfTmp.get();
+  }
+}
+
 // Compute residual error for the qstls iterations
 double Qstls::computeError() const {
   return rms(ssfNew, ssfOld, false);
@@ -245,7 +343,7 @@ void Qstls::updateSolution(){
   }
 }
 
-void Qstls::computeAdrFixed() {
+void Qstls::computeAdrFixed(MPI::GatherRequest &request) {
   // Check if it adrFixed can be loaded from input
   if (!in.getFixed().empty()) {
     readAdrFixedFile(adrFixed, in.getFixed(), false);
@@ -258,22 +356,196 @@ void Qstls::computeAdrFixed() {
   const int nxnl = nx * nl;
   const bool segregatedItg = in.getInt2DScheme() == "segregated";
   const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
+  const bool isGround = in.getDegeneracy() == 0.0;
+  const vector<bool> done = allocateAdrFixed();
+  ofstream checkpoint = openAdrFixedCheckpoint(done);
   // Parallel for loop (Hybrid MPI and OpenMP)
   auto loopFunc = [&](int i)->void{
-    Integrator2D itg2(in.getIntError());
-    AdrFixed adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(),
-		    wvg[i], mu, itgGrid, itg2);
-    adrTmp.get(wvg, adrFixed);
+    if (done[i]) { return; }
+    if (isGround) {
+      Integrator1D itg1(in.getIntError());
+      AdrFixedGround adrTmp(wvg[i], &freq(i), itg1);
+      adrTmp.get(wvg, adrFixed);
+    }
+    else {
+      Integrator2D itg2(in.getIntError());
+      AdrFixed adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(),
+		      wvg[i], mu, itgGrid, itg2);
+      adrTmp.get(wvg, adrFixed);
+    }
+    writeAdrFixedCheckpoint(checkpoint, i);
+  };
+  const auto& loopData = MPI::parallelFor(loopFunc, nx, in.getNThreads(),
+					  "fixed component",
+					  in.getProgressInterval());
+  request = MPI::gatherLoopDataAsync(adrFixed.data(), loopData, nxnl);
+}
+
+// The fixed component is shared among the ranks on the same node. The
+// rows recovered from the checkpoints of an interrupted calculation
+// are returned
+vector<bool> Qstls::allocateAdrFixed() {
+  const int nx = wvg.size();
+  const int nl = in.getNMatsubara();
+  adrFixed.setStorage(MPI::allocateShared(nx * nx * nl, nx, in.getNThreads()),
+		      nx, nl, nx);
+  return readAdrFixedCheckpoints();
+}
+
+// Low-rank representation of the fixed component. The frequencies are
+// distributed among the ranks and the factors are then shared with
+// all the ranks
+void Qstls::computeAdrFixedLowRank() {
+  adrFixedLowRank.clear();
+  const double relErr = in.getFixedLowRankError();
+  if (relErr == 0.0) { return; }
+  const int n1 = adrFixed.size(0);
+  const int nl = adrFixed.size(1);
+  const int n2 = adrFixed.size(2);
+  adrFixedLowRank.resize(nl);
+  auto loopFunc = [&](int l)->void{
+    adrFixedLowRank[l] = LowRankMatrix(adrFixed.slice(1, l), relErr);
   };
-  const auto& loopData = MPI::parallelFor(loopFunc, nx, in.getNThreads());
-  MPI::gatherLoopData(adrFixed.data(), loopData, nxnl);
-  // Write result to output file
+  const auto& loopData = MPI::parallelFor(loopFunc, nl, in.getNThreads());
+  if (MPI::isSingleProcess()) { return; }
+  const int thisRank = MPI::rank();
+  for (size_t r = 0; r < loopData.size(); ++r) {
+    const int root = r;
+    for (int l = loopData[r].first; l < loopData[r].second; ++l) {
+      int rank = adrFixedLowRank[l].getRank();
+      MPI::broadcast(&rank, 1, root);
+      vector<double> u = adrFixedLowRank[l].getU();
+      vector<double> v = adrFixedLowRank[l].getV();
+      u.resize(rank * n1);
+      v.resize(rank * n2);
+      MPI::broadcast(u.data(), u.size(), root);
+      MPI::broadcast(v.data(), v.size(), root);
+      if (thisRank != root) { adrFixedLowRank[l] = LowRankMatrix(n1, n2, u, v); }
+    }
+  }
+}
+
+// The rows of the fixed component are saved as soon as they are
+// computed to per-rank checkpoint files. If the calculation is
+// interrupted, the rows saved by all the ranks are recovered when the
+// calculation is restarted and only the missing rows are computed.
+// The files of groups of ranks that run concurrently on different
+// communicators are kept separate
+string Qstls::getAdrFixedCheckpointPrefix() const {
+  return fmt::format("adr_fixed_theta{:.3f}_matsubara{:}_group{}_rank",
+		     in.getDegeneracy(),
+		     in.getNMatsubara(),
+		     MPI::groupRoot());
+}
+
+vector<string> Qstls::getAdrFixedCheckpointFiles() const {
+  const string prefix = getAdrFixedCheckpointPrefix();
+  vector<string> out;
+  for (const auto& entry : filesystem::directory_iterator(".")) {
+    const string name = entry.path().filename().string();
+    if (name.rfind(prefix, 0) == 0 && entry.path().extension() == ".chk") {
+      out.push_back(name);
+    }
+  }
+  return out;
+}
+
+vector<bool> Qstls::readAdrFixedCheckpoints() {
+  const int nx = wvg.size();
+  const int nl = in.getNMatsubara();
+  vector<bool> done(nx, false);
+  // Only the leader writes the recovered data if the memory is
+  // shared among the ranks of the same node
+  const bool writeData = MPI::isNodeLeader();
+  vector<double> row(nl * nx);
+  for (const auto& fileName : getAdrFixedCheckpointFiles()) {
+    ifstream file;
+    file.open(fileName, ios::binary);
+    if (!file.is_open()) { continue; }
+    int nx_;
+    int nl_;
+    double Theta_;
+    vector<double> wvg_(nx);
+    readDataFromBinary<int>(file, nx_);
+    readDataFromBinary<int>(file, nl_);
+    readDataFromBinary<double>(file, Theta_);
+    if (!file || nx_ != nx) { continue; }
+    readDataFromBinary<vector<double>>(file, wvg_);
+    if (!file || checkAdrFixed(wvg_, Theta_, nl_) != 0) { continue; }
+    // Rows that were only partially written are discarded
+    while (true) {
+      int i;
+      readDataFromBinary<int>(file, i);
+      readDataFromBinary<vector<double>>(file, row);
+      if (!file || i < 0 || i >= nx) { break; }
+      if (writeData) {
+	std::copy(row.begin(), row.end(), &adrFixed(i, 0, 0));
+      }
+      done[i] = true;
+    }
+  }
+  MPI::syncShared(adrFixed.data());
+  // The checkpoint files can be overwritten only after all the ranks
+  // have read them
+  MPI::barrier();
+  return done;
+}
+
+ofstream Qstls::openAdrFixedCheckpoint(const vector<bool> &done) const {
+  const string fileName = fmt::format("{}{}.chk",
+				      getAdrFixedCheckpointPrefix(),
+				      MPI::rank());
+  ofstream file;
+  file.open(fileName, ios::binary);
+  if (!file.is_open()) {
+    MPI::throwError("Output file " + fileName + " could not be created.");
+  }
+  writeDataToBinary<int>(file, static_cast<int>(wvg.size()));
+  writeDataToBinary<int>(file, in.getNMatsubara());
+  writeDataToBinary<double>(file, in.getDegeneracy());
+  writeDataToBinary<vector<double>>(file, wvg);
+  file.flush();
+  // The recovered rows are saved again (distributed among the ranks),
+  // since opening the checkpoint discards the previous content
+  const int nx = wvg.size();
+  for (int i = MPI::rank(); i < nx; i += MPI::numberOfRanks()) {
+    if (done[i]) { writeAdrFixedCheckpoint(file, i); }
+  }
+  return file;
+}
+
+void Qstls::writeAdrFixedCheckpoint(ofstream &file,
+				    const int i) const {
+  const int nx = wvg.size();
+  const int nl = in.getNMatsubara();
+  #pragma omp critical (adrFixedCheckpoint)
+  {
+    writeDataToBinary<int>(file, i);
+    for (int l = 0; l < nl; ++l) {
+      for (int j = 0; j < nx; ++j) {
+	writeDataToBinary<double>(file, adrFixed(i, l, j));
+      }
+    }
+    file.flush();
+  }
+}
+
+void Qstls::removeAdrFixedCheckpoints() const {
+  MPI::barrier();
+  if (MPI::isRoot()) {
+    for (const auto& fileName : getAdrFixedCheckpointFiles()) {
+      filesystem::remove(fileName);
+    }
+  }
+}
+
+void Qstls::writeAdrFixed() const {
   if (MPI::isRoot()) {
     try {
       const string fileName = fmt::format("adr_fixed_theta{:.3f}_matsubara{:}.bin",
 					  in.getDegeneracy(),
 					  in.getNMatsubara());
-      writeAdrFixedFile(adrFixed, fileName);
+      writeAdrFixedFile(adrFixed, fileName, false);
     }
     catch (...) {
       MPI::throwError("Error in the output file for the fixed component"
@@ -283,29 +555,103 @@ void Qstls::computeAdrFixed() {
 }
 
 void Qstls::writeAdrFixedFile(const Vector3D &res,
-			      const string &fileName) const {
+			      const string &fileName,
+			      const bool iet) const {
   const int nx = wvg.size();
   const int nl = in.getNMatsubara();
   const double Theta = in.getDegeneracy();
+  const bool lowRank = iet && in.getFixedLowRankError() > 0.0;
   ofstream file;
   file.open(fileName, ios::binary);
   if (!file.is_open()) {
     MPI::throwError("Output file " + fileName + " could not be created.");
   }
-  writeDataToBinary<int>(file, nx);
-  writeDataToBinary<int>(file, nl);
+  // A negative number of frequencies marks the files that store the
+  // low-rank representation of each frequency. The frequencies for
+  // which the low-rank representation is not smaller than the full
+  // one are stored in full and are marked by a negative rank. A
+  // negative number of wave-vectors marks the files written in
+  // single precision
+  const bool singlePrecision = !lowRank && in.getFixedPrecision() == "single";
+  writeDataToBinary<int>(file, (singlePrecision) ? -nx : nx);
+  writeDataToBinary<int>(file, (lowRank) ? -nl : nl);
   writeDataToBinary<double>(file, Theta);
   writeDataToBinary<vector<double>>(file, wvg);
-  writeDataToBinary<Vector3D>(file, res);
+  if (lowRank) {
+    for (int l = 0; l < nl; ++l) {
+      const LowRankMatrix res_(res.slice(0, l), in.getFixedLowRankError());
+      const int rank = res_.getRank();
+      if (2 * rank < nx) {
+	writeDataToBinary<int>(file, rank);
+	writeDataToBinary<vector<double>>(file, res_.getU());
+	writeDataToBinary<vector<double>>(file, res_.getV());
+      }
+      else {
+	writeDataToBinary<int>(file, -1);
+	for (int i = 0; i < nx * nx; ++i) {
+	  writeDataToBinary<double>(file, (&res(l, 0, 0))[i]);
+	}
+      }
+    }
+  }
+  else if (singlePrecision) {
+    writeDataToBinary<vector<float>>(file, getAdrFixedSingle(res));
+  }
+  else {
+    writeDataToBinary<Vector3D>(file, res);
+  }
   file.close();
   if (!file) {
     MPI::throwError("Error in writing to file " + fileName);
   }
 }
 
+// Convert the fixed component to single precision. The round-off error
+// of each row (relative to the largest element of the row) must not
+// exceed the accuracy of the integrals that use the fixed component
+vector<float> Qstls::getAdrFixedSingle(const Vector3D &res) const {
+  const size_t n = res.size(2);
+  const size_t nRows = (n > 0) ? res.size() / n : 0;
+  vector<float> out(res.size());
+  double err = 0.0;
+  for (size_t r = 0; r < nRows; ++r) {
+    const double* row = res.data() + r * n;
+    float* rowOut = out.data() + r * n;
+    double rowMax = 0.0;
+    double rowErr = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+      rowOut[j] = static_cast<float>(row[j]);
+      rowMax = max(rowMax, abs(row[j]));
+      rowErr = max(rowErr, abs(rowOut[j] - row[j]));
+    }
+    if (rowMax > 0.0) { err = max(err, rowErr / rowMax); }
+    if (!isfinite(rowErr)) { err = numUtil::Inf; }
+  }
+  if (err > in.getIntError()) {
+    MPI::throwError("The fixed component of the auxiliary density response"
+		    " cannot be stored in single precision with the"
+		    " requested accuracy");
+  }
+  return out;
+}
+
 void Qstls::readAdrFixedFile(Vector3D &res,
 			     const string &fileName,
 			     const bool iet) const {
+  vector<LowRankMatrix> resLowRank;
+  readAdrFixedFile(res, resLowRank, fileName, iet);
+  if (!resLowRank.empty()) {
+    MPI::throwError("Unexpected low-rank fixed component in " + fileName);
+  }
+}
+
+// The frequencies stored with their low-rank representation are
+// written to resLowRank and the other frequencies are written to res
+void Qstls::readAdrFixedFile(Vector3D &res,
+			     vector<LowRankMatrix> &resLowRank,
+			     const string &fileName,
+			     const bool iet) const {
+  resLowRank.clear();
   if (fileName.empty()) { return; }
   const int nx = wvg.size();
   const int nl = in.getNMatsubara();
@@ -323,13 +669,51 @@ void Qstls::readAdrFixedFile(Vector3D &res,
   readDataFromBinary<double>(file, Theta_);
   wvg_.resize(nx);
   readDataFromBinary<vector<double>>(file, wvg_);
-  if (iet) { res.resize(nl, nx, nx); }
-  else { res.resize(nx, nl, nx); }
-  readDataFromBinary<Vector3D>(file, res);
+  const bool lowRank = iet && nl_ < 0;
+  if (lowRank) { nl_ = -nl_; }
+  const bool singlePrecision = nx_ < 0;
+  const size_t nData = static_cast<size_t>(nx) * nl * nx;
+  if (lowRank) { res = Vector3D(); }
+  else if (iet) { res.resize(nl, nx, nx); }
+  else { res.setStorage(MPI::allocateShared(nx * nl * nx), nx, nl, nx); }
+  // Shared memory is filled only by the leader of each node
+  const bool readData = iet || MPI::isNodeLeader();
+  if (lowRank) {
+    resLowRank.resize(nl);
+    for (int l = 0; l < nl && file; ++l) {
+      int rank = 0;
+      readDataFromBinary<int>(file, rank);
+      if (rank < 0) {
+	if (res.empty()) { res.resize(nl, nx, nx); }
+	for (int i = 0; i < nx * nx; ++i) {
+	  readDataFromBinary<double>(file, (&res(l, 0, 0))[i]);
+	}
+	continue;
+      }
+      if (rank > nx) {
+	file.setstate(ios::failbit);
+	break;
+      }
+      vector<double> u(rank * nx);
+      vector<double> v(rank * nx);
+      readDataFromBinary<vector<double>>(file, u);
+      readDataFromBinary<vector<double>>(file, v);
+      if (file) { resLowRank[l] = LowRankMatrix(nx, nx, u, v); }
+    }
+  }
+  else if (readData && singlePrecision) {
+    vector<float> tmp(nData);
+    readDataFromBinary<vector<float>>(file, tmp);
+    std::copy(tmp.begin(), tmp.end(), res.begin());
+  }
+  else if (readData) {
+    readDataFromBinary<Vector3D>(file, res);
+  }
   file.close();
   if (!file) {
     MPI::throwError("Error in reading from file " + fileName);
   }
+  if (!iet) { MPI::syncShared(res.data()); }
   if (checkAdrFixed(wvg_, Theta_, nl_) != 0) {
     MPI::throwError("Fixed component of the auxiliary density response"
 		    " loaded from file is incompatible with input");
@@ -353,7 +737,8 @@ int Qstls::checkAdrFixed(const vector<double> &wvg_,
   return 0;
 }
 
-void Qstls::computeAdrIet() {
+void Qstls::computeAdrIet(Vector2D &adrIet,
+			  MPI::GatherRequest &request) {
   const int nx = wvg.size();
   const int nl = in.getNMatsubara();
   const bool segregatedItg = in.getInt2DScheme() == "segregated";
@@ -372,19 +757,31 @@ void Qstls::computeAdrIet() {
   }
   // Compute qstls-iet contribution to the adr
   const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
-  Vector2D adrIet(nx, nl);
-  auto loopFunc = [&](int i)->void{
-    Integrator2D itgPrivate(in.getIntError());
-    Vector3D adrFixedPrivate;
-    readAdrFixedFile(adrFixedPrivate, adrFixedIetFileInfo.at(i).first, true);
-    AdrIet adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(),
-		  wvg[i], ssfi, dlfci, bfi, itgGrid, itgPrivate);
-    adrTmp.get(wvg, adrFixedPrivate, adrIet);
+  adrIet.resize(nx, nl);
+  // The fixed components for the wave-vectors assigned to this rank
+  // are read on a separate thread while the threads in the OpenMP
+  // region compute the wave-vectors that were already read
+  const auto loopData = MPI::getAllLoopIndexes(nx);
+  const auto& thisIdx = loopData[MPI::rank()];
+  vector<int> idx(thisIdx.second - thisIdx.first);
+  iota(idx.begin(), idx.end(), thisIdx.first);
+  auto loader = [&](const int i, AdrFixedIetData& res)->void{
+    readAdrFixedFile(res.full, res.lowRank, adrFixedIetFileInfo.at(i).first, true);
   };
-  const auto& loopData = MPI::parallelFor(loopFunc, nx, in.getNThreads());
-  MPI::gatherLoopData(adrIet.data(), loopData, nl);
-  // Sum qstls and qstls-iet contributions to adr
-  adr.sum(adrIet);
+  const int nThreads = in.getNThreads();
+  AdrFixedIetReader reader(loader, idx, 2 * nThreads);
+  #pragma omp parallel num_threads(nThreads) if (nThreads > 1)
+  {
+    Integrator2D itgPrivate(itgError);
+    int i;
+    shared_ptr<AdrFixedIetData> adrFixedPrivate;
+    while (reader.next(i, adrFixedPrivate)) {
+      AdrIet adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(),
+		    wvg[i], ssfi, dlfci, bfi, itgGrid, itgPrivate);
+      adrTmp.get(wvg, *adrFixedPrivate, adrIet);
+    }
+  }
+  request = MPI::gatherLoopDataAsync(adrIet.data(), loopData, nl);
 }
 
 void Qstls::computeAdrFixedIet() {
@@ -396,15 +793,8 @@ void Qstls::computeAdrFixedIet() {
   for (const auto &member : adrFixedIetFileInfo) {
     if(!member.second.second) { idx.push_back(member.first); };
   }
-  // Check that all ranks found the same number of files
-  int nFilesToWrite = idx.size();
-  if (!MPI::isEqualOnAllRanks(idx.size())) {
-    MPI::throwError("Not all ranks can access the files with the fixed "
-		    " component of the auxiliary density response");
-  }
+  const int nFilesToWrite = idx.size();
   if (nFilesToWrite == 0) { return; }
-  // Barrier to ensure that all ranks have identified all the files that have to be written
-  MPI::barrier();  
   // Write necessary files
   auto loopFunc = [&](int i)->void{
     Integrator1D itgPrivate(in.getIntError());
@@ -412,37 +802,50 @@ void Qstls::computeAdrFixedIet() {
     AdrFixedIet adrTmp(in.getDegeneracy(), wvg.front(), wvg.back(),
 		       wvg[idx[i]], mu, itgPrivate);
     adrTmp.get(wvg, res);
-    writeAdrFixedFile(res, adrFixedIetFileInfo.at(idx[i]).first);
+    writeAdrFixedFile(res, adrFixedIetFileInfo.at(idx[i]).first, true);
   };
-  MPI::parallelFor(loopFunc, nFilesToWrite, in.getNThreads());
-  // Update content of adrFixedIetFileInfo
-  getAdrFixedIetFileInfo();
+  MPI::parallelFor(loopFunc, nFilesToWrite, in.getNThreads(),
+		   "fixed component (iet)", in.getProgressInterval());
+  // Barrier to ensure that all the files are written before they are read
+  MPI::barrier();
+  for (const int& i : idx) { adrFixedIetFileInfo.at(i).second = true; }
 }
 
 void Qstls::getAdrFixedIetFileInfo() {
   const int nx = wvg.size();
   adrFixedIetFileInfo.clear();
-  for (int i=0; i<nx; ++i) {
-    try {
-      string name = fmt::format("adr_fixed_theta{:.3f}_matsubara{:}_{}_wv{:.5f}.bin",
-				                        in.getDegeneracy(),
-				                        in.getNMatsubara(),
-				                        in.getTheory(),
-				                        wvg[i]);
-      if (!in.getFixedIet().empty()) {
-	std::filesystem::path fullPath = in.getFixedIet();
-	fullPath /= name;
-	name = fullPath.string();
+  // Only the root rank queries the file system, with a single listing
+  // of the folder with the fixed components, and shares the result
+  // with the other ranks
+  vector<int> found(nx, 0);
+  try {
+    const filesystem::path dir = (in.getFixedIet().empty()) ? "." : in.getFixedIet();
+    vector<string> names(nx);
+    for (int i=0; i<nx; ++i) {
+      names[i] = fmt::format("adr_fixed_theta{:.3f}_matsubara{:}_{}_wv{:.5f}.bin",
+			     in.getDegeneracy(),
+			     in.getNMatsubara(),
+			     in.getTheory(),
+			     wvg[i]);
+    }
+    if (MPI::isRoot() && filesystem::is_directory(dir)) {
+      set<string> existing;
+      for (const auto& entry : filesystem::directory_iterator(dir)) {
+	existing.insert(entry.path().filename().string());
       }
-      const bool found = std::filesystem::exists(name);
-      const pair<string,bool> filePair = pair<string,bool>(name,found);
-      adrFixedIetFileInfo.insert(pair<int,decltype(filePair)>(i,filePair));
+      for (int i=0; i<nx; ++i) { found[i] = existing.count(names[i]); }
     }
-    catch (...) {
-      MPI::throwError("Error in the output file for the fixed component"
-		      " of the auxiliary density response.");
+    MPI::broadcast(found.data(), nx, 0);
+    for (int i=0; i<nx; ++i) {
+      const string name = (in.getFixedIet().empty())
+	? names[i] : (dir / names[i]).string();
+      adrFixedIetFileInfo.insert(pair<int,pair<string,bool>>(i, {name, found[i] == 1}));
     }
   }
+  catch (...) {
+    MPI::throwError("Error in the output file for the fixed component"
+		    " of the auxiliary density response.");
+  }
 }
 
 // Recovery files
@@ -531,6 +934,25 @@ double Qssf::get() const {
   return ssfHF - 1.5 * f1/x2 * Theta * f3;
 }
 
+// -----------------------------------------------------------------
+// QssfGround class
+// -----------------------------------------------------------------
+
+// Get static structure factor. The sum over the Matsubara frequencies
+// is replaced by an integral over the imaginary frequencies
+double QssfGround::get() const {
+  if (rs == 0.0) return ssfHF;
+  if (x == 0.0) return 0.0;
+  const double f1 = 4.0*lambda*rs/M_PI;
+  const double x2 = x*x;
+  double f3 = 0.0;
+  for (int l=0; l<nl; ++l) {
+    const double f4 = idr[l] - adr[l];
+    const double f5 = 1.0 + f1/x2*f4;
+    f3 += w[l] * idr[l]*f4/f5;
+  }
+  return ssfHF - 1.5 * f1/x2 * f3 / M_PI;
+}
 
 // -----------------------------------------------------------------
 // AdrBase class
@@ -570,7 +992,7 @@ void Adr::get(const vector<double> &wvg,
   }
   const auto itgParam = ItgParam(yMin, yMax);
   for (int l = 0; l < nl; ++l){
-    fixi.reset(wvg[0], fixed(ix,l), nx);
+    fixi.reset(wvg[0], fixed.slice(1, l).row(ix), nx);
     auto func = [&](const double& y)->double{return integrand(y);};
     itg.compute(func, itgParam);
     res(ix, l) = itg.getSolution();
@@ -578,6 +1000,37 @@ void Adr::get(const vector<double> &wvg,
   }
 }
 
+// -----------------------------------------------------------------
+// AdrLowRank class
+// -----------------------------------------------------------------
+
+// Get result of integration. The static structure factor is a cubic
+// spline on the same grid, so four Gauss-Legendre nodes integrate
+// exactly the polynomial in each interval
+void AdrLowRank::get(const vector<double> &wvg,
+		     const vector<LowRankMatrix> &fixed,
+		     Vector2D &res) {
+  const int nx = wvg.size();
+  const int nl = fixed.size();
+  assert(yMin == wvg.front() && yMax == wvg.back());
+  auto kernel = [&](const double& y)->double{ return y * (ssf(y) - 1.0); };
+  const SplineFunctional functional(wvg, kernel, 4);
+  const vector<double>& weights = functional.getWeights();
+  res.fill(0.0);
+  for (int l = 0; l < nl; ++l) {
+    for (size_t k = 0; k < fixed[l].getRank(); ++k) {
+      const double* v = fixed[l].getV(k);
+      const double sol = inner_product(weights.begin(), weights.end(), v, 0.0);
+      const double* u = fixed[l].getU(k);
+      for (int i = 0; i < nx; ++i) { res(i, l) += u[i] * sol; }
+    }
+    const double scale = (l == 0) ? isc0 : isc;
+    for (int i = 0; i < nx; ++i) {
+      res(i, l) = (wvg[i] == 0.0) ? 0.0 : scale * res(i, l);
+    }
+  }
+}
+
 // -----------------------------------------------------------------
 // AdrFixed class
 // -----------------------------------------------------------------
@@ -587,11 +1040,14 @@ void AdrFixed::get(vector<double> &wvg,
 		   Vector3D &res) const {
   const int nx = wvg.size();
   const int nl = res.size(1);
-  if ( x == 0.0 ) { res.fill(0.0); };
   const double x2 = x*x;
   auto it = find(wvg.begin(), wvg.end(), x);
   assert(it != wvg.end());
   size_t ix = distance(wvg.begin(), it);
+  if (x == 0.0) {
+    for (int l = 0; l < nl; ++l) { res.fill(ix, l, 0.0); }
+    return;
+  }
   for (int l = 0; l < nl; ++l){
     for (int i = 0; i < nx; ++i) {
       const double xq = x*wvg[i];
@@ -638,6 +1094,134 @@ double AdrFixed::integrand2(const double& t,
   return 1.0/(2.0*t + y*y - x*x)*log(logarg);
 }
 
+// -----------------------------------------------------------------
+// AdrFixedMulti class
+// -----------------------------------------------------------------
+
+// Get fixed component
+void AdrFixedMulti::get(const vector<double> &wvg,
+			const vector<Vector3D*> &res) const {
+  const int nx = wvg.size();
+  const int nl = res.front()->size(1);
+  const size_t nTheta = Theta.size();
+  const double x2 = x*x;
+  auto it = find(wvg.begin(), wvg.end(), x);
+  assert(it != wvg.end());
+  size_t ix = distance(wvg.begin(), it);
+  if (x == 0.0) {
+    for (auto r : res) {
+      for (int l = 0; l < nl; ++l) { r->fill(ix, l, 0.0); }
+    }
+    return;
+  }
+  for (int l = 0; l < nl; ++l){
+    for (int i = 0; i < nx; ++i) {
+      const double xq = x*wvg[i];
+      auto tMin = x2 - xq;
+      auto tMax = x2 + xq;
+      auto func1 = [&](const double& q, vector<double>& f)->void{
+	integrand1(q, l, f);
+      };
+      auto func2 = [&](const double& t, vector<double>& f)->void{
+	integrand2(t, wvg[i], l, f);
+      };
+      // For l = 0 the level 2 integrand does not depend on the
+      // degeneracy parameter and is integrated only once
+      const size_t n2 = (l == 0) ? 1 : nTheta;
+      itg.compute(func1, func2, Itg2DParam(qMin, qMax, tMin, tMax),
+		  itgGrid, nTheta, n2);
+      const vector<double>& sol = itg.getSolution();
+      for (size_t k = 0; k < nTheta; ++k) { (*res[k])(ix, l, i) = sol[k]; }
+    }
+  }
+}
+
+// Integrands for the fixed component
+void AdrFixedMulti::integrand1(const double& q,
+			       const int& l,
+			       vector<double>& res) const {
+  const double q2 = q*q;
+  for (size_t k = 0; k < Theta.size(); ++k) {
+    const double arg = q2/Theta[k] - mu[k];
+    res[k] = (l == 0) ? q/(exp(arg) + exp(-arg) + 2.0) : q/(exp(arg) + 1.0);
+  }
+}
+
+void AdrFixedMulti::integrand2(const double& t,
+			       const double& y,
+			       const int& l,
+			       vector<double>& res) const {
+  const double q = itg.getX();
+  if (q == 0 || t == 0 || y == 0) {
+    fill(res.begin(), res.end(), 0.0);
+    return;
+  }
+  // The geometric terms do not depend on the degeneracy parameter
+  const double x2 = x*x;
+  const double y2 = y*y;
+  const double q2 = q*q;
+  const double txq = 2.0 * x * q;
+  const double denom = 2.0*t + y2 - x2;
+  if (l == 0) {
+    // Only one component (independent of the degeneracy parameter)
+    if (t == txq) { res[0] = 2.0*q2/(y2 + 2.0*txq - x2); return; }
+    const double t2 = t*t;
+    double logarg = (t + txq)/(t - txq);
+    logarg = (logarg < 0.0) ? -logarg : logarg;
+    res[0] = 1.0/denom*((q2 - t2/(4.0*x2))*log(logarg) + q*t/x);
+    return;
+  }
+  const double txqpt = txq + t;
+  const double txqmt = txq - t;
+  const double txqpt2 = txqpt*txqpt;
+  const double txqmt2 = txqmt*txqmt;
+  for (size_t k = 0; k < Theta.size(); ++k) {
+    const double tplT = 2.0 * M_PI * l * Theta[k];
+    const double tplT2 = tplT*tplT;
+    const double logarg = (txqpt2 + tplT2)/(txqmt2 + tplT2);
+    res[k] = 1.0/denom*log(logarg);
+  }
+}
+
+// -----------------------------------------------------------------
+// AdrFixedGround class
+// -----------------------------------------------------------------
+
+// Get fixed component
+void AdrFixedGround::get(vector<double> &wvg,
+			 Vector3D &res) const {
+  const int nx = wvg.size();
+  const int nl = res.size(1);
+  const double x2 = x*x;
+  auto it = find(wvg.begin(), wvg.end(), x);
+  assert(it != wvg.end());
+  size_t ix = distance(wvg.begin(), it);
+  for (int l = 0; l < nl; ++l){
+    for (int i = 0; i < nx; ++i) {
+      const double y = wvg[i];
+      if (x == 0.0 || y == 0.0) {
+	res(ix, l, i) = 0.0;
+	continue;
+      }
+      auto func = [&](const double& t)->double{return integrand(t, y, nu[l]);};
+      itg.compute(func, ItgParam(x2 - x*y, x2 + x*y));
+      res(ix, l, i) = itg.getSolution();
+    }
+  }
+}
+
+// Integrand for the fixed component. The integral over the occupied
+// states (q < 1) is the ideal density response evaluated at the
+// wave-vector |t|/x and at the imaginary frequency |t|*nu/x^2
+double AdrFixedGround::integrand(const double& t,
+				 const double& y,
+				 const double& nu_) const {
+  if (t == 0.0) { return 0.0; }
+  const double xt = abs(t)/x;
+  const double idr = IdrGround(xt * nu_ / x, xt).imagFreq0();
+  return 2.0 * t / x * idr / (2.0*t + y*y - x*x);
+}
+
 // -----------------------------------------------------------------
 // AdrIet class
 // -----------------------------------------------------------------
@@ -656,7 +1240,38 @@ double AdrIet::bf(const double& y) const {
 // Compute fixed component
 double AdrIet::fix(const double& x,
 		   const double& y) const {
-  return fixi.eval(x,y);
+  if (!fixLowRank) { return fixi.eval(x,y); }
+  if (x != fixX) {
+    fixX = x;
+    for (size_t k = 0; k < fixU.size(); ++k) { fixU[k] = fixiU[k].eval(x); }
+  }
+  double out = 0.0;
+  for (size_t k = 0; k < fixU.size(); ++k) { out += fixU[k] * fixiV[k].eval(y); }
+  return out;
+}
+
+// Setup the interpolators for the frequency l
+void AdrIet::setupFix(const vector<double> &wvg,
+		      const AdrFixedIetData &fixed,
+		      const int& l) {
+  const bool lowRank = l < static_cast<int>(fixed.lowRank.size())
+    && !fixed.lowRank[l].empty();
+  if (!lowRank) {
+    fixLowRank = nullptr;
+    fixi.reset(wvg[0], wvg[0], fixed.full.slice(0, l));
+    return;
+  }
+  const int nx = wvg.size();
+  const size_t rank = fixed.lowRank[l].getRank();
+  fixLowRank = &fixed.lowRank[l];
+  fixiU = vector<Interpolator1D>(rank);
+  fixiV = vector<Interpolator1D>(rank);
+  for (size_t k = 0; k < rank; ++k) {
+    fixiU[k].reset(wvg[0], *fixLowRank->getU(k), nx);
+    fixiV[k].reset(wvg[0], *fixLowRank->getV(k), nx);
+  }
+  fixX = numUtil::NaN;
+  fixU.resize(rank);
 }
 
 // Integrands
@@ -675,10 +1290,9 @@ double AdrIet::integrand2(const double& y) const {
 
 // Get result of integration
 void AdrIet::get(const vector<double> &wvg,
-		 const Vector3D &fixed,
+		 const AdrFixedIetData &fixed,
 		 Vector2D &res) {
-  const int nx = wvg.size();
-  const int nl = fixed.size(0);
+  const int nl = dlfci.size();
   auto it = lower_bound(wvg.begin(), wvg.end(), x);
   assert(it != wvg.end());
   size_t ix = distance(wvg.begin(), it);
@@ -687,7 +1301,7 @@ void AdrIet::get(const vector<double> &wvg,
     return;
   }
   for (int l = 0; l < nl; ++l) {
-    fixi.reset(wvg[0], wvg[0], fixed(l), nx, nx);
+    setupFix(wvg, fixed, l);
     auto yMin = [&](const double& q)->double{return (q > x) ? q - x : x - q;};
     auto yMax = [&](const double& q)->double{return min(qMax, q + x);};
     auto func1 = [&](const double& q)->double{return integrand1(q, l);};
@@ -752,3 +1366,64 @@ double AdrFixedIet::integrand(const double& t,
     ((qmypx - fxt)*(qmypx - fxt) + fplT2);
   return t / (exp(t2/Theta - mu) + 1.0)*log(logarg);
 }
+
+// -----------------------------------------------------------------
+// AdrFixedIetReader class
+// -----------------------------------------------------------------
+
+AdrFixedIetReader::AdrFixedIetReader(const Loader& loader_,
+				     const vector<int>& idx_,
+				     const size_t capacity_)
+  : loader(loader_), idx(idx_), capacity(max(capacity_, size_t(1))),
+    nRead(0), stopped(false) {
+  reader = thread(&AdrFixedIetReader::read, this);
+}
+
+AdrFixedIetReader::~AdrFixedIetReader() {
+  {
+    lock_guard<mutex> lock(mtx);
+    stopped = true;
+  }
+  bufferUsed.notify_all();
+  reader.join();
+}
+
+void AdrFixedIetReader::read() {
+  for (const int& i : idx) {
+    {
+      unique_lock<mutex> lock(mtx);
+      bufferUsed.wait(lock, [&]{ return stopped || buffers.size() < capacity; });
+      if (stopped) { return; }
+    }
+    auto data = make_shared<AdrFixedIetData>();
+    try {
+      loader(i, *data);
+    }
+    catch (...) {
+      lock_guard<mutex> lock(mtx);
+      error = current_exception();
+      stopped = true;
+    }
+    {
+      lock_guard<mutex> lock(mtx);
+      if (!error) { buffers.push_back(Buffer(i, data)); }
+      ++nRead;
+    }
+    bufferRead.notify_all();
+    if (error) { return; }
+  }
+}
+
+bool AdrFixedIetReader::next(int& i,
+			     shared_ptr<AdrFixedIetData>& data) {
+  unique_lock<mutex> lock(mtx);
+  bufferRead.wait(lock, [&]{ return error || !buffers.empty() || nRead == idx.size(); });
+  if (error) { rethrow_exception(error); }
+  if (buffers.empty()) { return false; }
+  i = buffers.front().first;
+  data = buffers.front().second;
+  buffers.pop_front();
+  lock.unlock();
+  bufferUsed.notify_one();
+  return true;
+}
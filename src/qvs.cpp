@@ -6,6 +6,7 @@
 
 using namespace std;
 using namespace vecUtil;
+using namespace parallelUtil;
 using ItgParam = Integrator1D::Param;
 using Itg2DParam = Integrator2D::Param;
 using ItgType = Integrator1D::Type;
@@ -112,6 +113,21 @@ void QStructProp::setupCSRDependencies() {
   }
 }
 
+void QStructProp::init() {
+  // The state points that are used as source for the fixed component
+  // of the auxiliary density response are initialized together
+  vector<QStlsCSR*> group;
+  for (const size_t i : {RS_DOWN_THETA_DOWN, RS_DOWN_THETA, RS_DOWN_THETA_UP}) {
+    const auto& in = csr[i].getInput();
+    if (in.getFixed().empty() && in.getDegeneracy() > 0.0) {
+      group.push_back(&csr[i]);
+    }
+  }
+  if (!group.empty()) { QStlsCSR::init(group); }
+  for (auto& c : csr) {
+    if (find(group.begin(), group.end(), &c) == group.end()) { c.init(); }
+  }
+}
 
 void QStructProp::doIterations() {
   const auto& in = csr[0].getInput();
@@ -122,26 +138,33 @@ void QStructProp::doIterations() {
   int counter = 0;
   // Define initial guess
   for (auto& c : csr) { c.initialGuess(); }
-  // Iteration to solve for the structural properties
+  // Iteration to solve for the structural properties. The state points
+  // are distributed among the MPI ranks and, within each rank, among
+  // the OpenMP threads. The work on each state point does not
+  // communicate with the other ranks
   const bool useOMP = ompThreads > 1;
+  const int nLocal = localCsr.size();
   while (counter < maxIter+1 && err > minErr ) {
-    #pragma omp parallel num_threads(ompThreads) if (useOMP)
-    {
-      #pragma omp for
-      for (auto& c : csr) {
-        c.computeAdrStls();
-      }
-      #pragma omp for
-      for (size_t i = 0; i < csr.size(); ++i) {
-        auto& c = csr[i];
-        c.computeAdr();
-        c.computeSsf();
-        if (i == RS_THETA) {err = c.computeError(); }
-        c.updateSolution(); 
-      }
-      counter++;
+    #pragma omp parallel for num_threads(ompThreads) if (useOMP)
+    for (int k = 0; k < nLocal; ++k) {
+      MPI::LocalScope localScope;
+      csr[localCsr[k]].computeAdrStls();
+    }
+    exchangeLfc();
+    #pragma omp parallel for num_threads(ompThreads) if (useOMP)
+    for (int k = 0; k < nLocal; ++k) {
+      MPI::LocalScope localScope;
+      const size_t i = localCsr[k];
+      auto& c = csr[i];
+      c.computeAdr();
+      c.computeSsf();
+      if (i == RS_THETA) {err = c.computeError(); }
+      c.updateSolution(); 
     }
+    broadcastError(err);
+    counter++;
   }
+  broadcastSolution();
   if (verbose) {
     printf("Alpha = %.5e, Residual error "
 	   "(structural properties) = %.5e\n",
@@ -164,12 +187,64 @@ vector<double> QStructProp::getQ() const  {
 void QStlsCSR::init() {
   if (adrFixedSource) {
     Stls::init();
-    adrFixed = *adrFixedSource;
+    adrFixed.share(adrFixedSource->adrFixed);
+    adrFixedLowRank = adrFixedSource->adrFixedLowRank;
     return;
   }
   Qstls::init();
 }
 
+void QStlsCSR::init(const vector<QStlsCSR*>& group) {
+  // The chemical potentials are needed to compute the fixed component
+  for (auto c : group) { c->Stls::init(); }
+  const auto& in = group.front()->in;
+  const auto& wvg = group.front()->wvg;
+  const int nx = wvg.size();
+  const int nl = in.getNMatsubara();
+  const int nxnl = nx * nl;
+  const bool segregatedItg = in.getInt2DScheme() == "segregated";
+  const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
+  vector<double> Theta;
+  vector<double> mu;
+  vector<Vector3D*> adrFixed;
+  vector<ofstream> checkpoint;
+  vector<bool> done(nx, true);
+  for (auto c : group) {
+    Theta.push_back(c->in.getDegeneracy());
+    mu.push_back(c->mu);
+    const vector<bool> doneTmp = c->allocateAdrFixed();
+    adrFixed.push_back(&c->adrFixed);
+    // Rows are skipped only if they were recovered for all the state points
+    for (int i = 0; i < nx; ++i) { done[i] = done[i] && doneTmp[i]; }
+    checkpoint.push_back(c->openAdrFixedCheckpoint(doneTmp));
+  }
+  // Parallel for loop (Hybrid MPI and OpenMP)
+  auto loopFunc = [&](int i)->void{
+    if (done[i]) { return; }
+    VectorIntegrator2D itg2(in.getIntError());
+    AdrFixedMulti adrTmp(Theta, mu, wvg.front(), wvg.back(),
+			 wvg[i], itgGrid, itg2);
+    adrTmp.get(wvg, adrFixed);
+    for (size_t k = 0; k < group.size(); ++k) {
+      group[k]->writeAdrFixedCheckpoint(checkpoint[k], i);
+    }
+  };
+  const auto& loopData = MPI::parallelFor(loopFunc, nx, in.getNThreads(),
+					  "fixed component",
+					  in.getProgressInterval());
+  vector<MPI::GatherRequest> requests;
+  for (auto c : group) {
+    requests.push_back(MPI::gatherLoopDataAsync(c->adrFixed.data(), loopData, nxnl));
+  }
+  for (auto& r : requests) { r.wait(); }
+  for (auto c : group) { c->finalizeAdrFixed(); }
+}
+
+void QStlsCSR::broadcastSolution(const int root) {
+  MPI::broadcast(ssfOld.data(), ssfOld.size(), root);
+  MPI::broadcast(adr.data(), adr.size(), root);
+}
+
 void QStlsCSR::computeAdrStls() {
   Qstls::computeAdr();
   *lfc = adr;
@@ -224,16 +299,12 @@ void QStlsCSR::computeAdr() {
 }
 
 double QStlsCSR::getQAdder() const {
-  Integrator1D itg1(ItgType::DEFAULT, in.getIntError());
-  Integrator2D itg2(ItgType::SINGULAR,
-		    ItgType::DEFAULT,
-		    in.getIntError());
-  const bool segregatedItg = in.getInt2DScheme() == "segregated";
-  const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
-  const Interpolator1D ssfItp(wvg, ssf);
-  QAdder QTmp(in.getDegeneracy(), mu, wvg.front(), wvg.back(), 
-              itgGrid, itg1, itg2, ssfItp); 
-  return QTmp.get();
+  if (qAdderFunctional.empty()) {
+    Integrator1D itg(ItgType::DEFAULT, in.getIntError());
+    const QAdder QTmp(in.getDegeneracy(), mu, wvg.front(), wvg.back(), itg);
+    qAdderFunctional = QTmp.getFunctional(wvg);
+  }
+  return qAdderFunctional.eval(ssf, 1.0);
 }
 
 double QStlsCSR::getDerivative(const shared_ptr<Vector2D>& f,
@@ -265,20 +336,15 @@ double QStlsCSR::getDerivative(const shared_ptr<Vector2D>& f,
 // QAdder class
 // -----------------------------------------------------------------
 
-// SSF interpolation
-double QAdder::ssf(const double& y) const {
-  return interp.eval(y);
-}
-
 // Denominator integrand
 double QAdder::integrandDenominator(const double y) const {
   const double y2 = y*y;
   return 1.0/(exp(y2/Theta - mu) + 1.0);
 }
 
-// Numerator integrand1
-double QAdder::integrandNumerator1(const double q) const {
-  const double w = itg2.getX();
+// Numerator integrand
+double QAdder::integrandNumerator(const double q,
+				  const double w) const {
   if (q == 0.0) { return 0.0; };
   double w2 = w*w;
   double w3 = w2*w;
@@ -287,25 +353,27 @@ double QAdder::integrandNumerator1(const double q) const {
   return q/(exp(q*q/Theta - mu) + 1.0) * q/w3 * (q/w * log(logarg) - 1.0);
 }
 
-// Numerator integrand2
-double QAdder::integrandNumerator2(const double w) const {
-  return w * (ssf(w) - 1.0);
-}
-
 // Denominator integral
 void QAdder::getIntDenominator(double &res) const {
   auto func = [&](double y)->double{return integrandDenominator(y);};
-  itg1.compute(func, ItgParam(limits.first, limits.second));
-  res = itg1.getSolution();
+  itg.compute(func, ItgParam(limits.first, limits.second));
+  res = itg.getSolution();
+}
+
+// Kernel of the integral over the wave-vector
+double QAdder::kernel(const double w) const {
+  auto func = [&](const double& q)->double{return integrandNumerator(q, w);};
+  itg.compute(func, ItgParam(limits.first, limits.second));
+  return w * itg.getSolution();
 }
 
-// Get total QAdder
-double QAdder::get() const {
+// Get the functional for the QAdder. The Q-adder is linear in ssf - 1
+// and the kernel of the integral over the wave-vector does not depend
+// on the static structure factor, hence the weights are computed once
+SplineFunctional QAdder::getFunctional(const vector<double>& wvg) const {
   double Denominator;
   getIntDenominator(Denominator);
-  auto func1 = [&](const double& w)->double{return integrandNumerator2(w);};
-  auto func2 = [&](const double& q)->double{return integrandNumerator1(q);};
-  itg2.compute(func1, func2, Itg2DParam(limits.first, limits.second,
-					limits.first, limits.second), itgGrid);
-  return 12.0 / (M_PI * lambda) * itg2.getSolution()/Denominator;
+  const double scale = 12.0 / (M_PI * lambda * Denominator);
+  auto func = [&](const double& w)->double{return scale * kernel(w);};
+  return SplineFunctional(wvg, func, 4);
 }
@@ -0,0 +1,222 @@
+#include <cmath>
+#include "util.hpp"
+#include "numerics.hpp"
+#include "input.hpp"
+#include "chemical_potential.hpp"
+#include "rpa.hpp"
+#include "qstls.hpp"
+#include "resource_plan.hpp"
+
+using namespace std;
+using namespace vecUtil;
+using namespace parallelUtil;
+
+// -----------------------------------------------------------------
+// ResourcePlan class
+// -----------------------------------------------------------------
+
+// Constructors
+ResourcePlan::ResourcePlan(const RpaInput &in_)
+  : in(in_), isQuantum(false), useIet(false), nStatePoints(1), nFixed(0),
+    computeFixed(false), computeFixedIet(false),
+    fixedElementSize(sizeof(double)), useLowRank(false),
+    nThreads(in_.getNThreads()), nRanks(MPI::numberOfRanks()),
+    nNodeRanks(MPI::numberOfNodeRanks()), nl(in_.getNMatsubara()),
+    itgTime(numUtil::NaN) {
+  nx = Rpa::buildWvGrid(in).size();
+}
+
+ResourcePlan::ResourcePlan(const QstlsInput &in_)
+  : ResourcePlan(static_cast<const RpaInput&>(in_)) {
+  const string theory = in_.getTheory();
+  isQuantum = true;
+  useIet = theory == "QSTLS-HNC" || theory == "QSTLS-IOI" || theory == "QSTLS-LCT";
+  nFixed = 1;
+  computeFixed = in_.getFixed().empty();
+  computeFixedIet = useIet && in_.getFixedIet().empty();
+  if (in_.getFixedPrecision() == "single") { fixedElementSize = sizeof(float); }
+  useLowRank = in_.getFixedLowRankError() > 0.0;
+}
+
+// The VS schemes solve three coupling parameters for each of three
+// degeneracy parameters at the same time
+ResourcePlan::ResourcePlan(const VSStlsInput &in_)
+  : ResourcePlan(static_cast<const RpaInput&>(in_)) {
+  nStatePoints = 9;
+}
+
+ResourcePlan::ResourcePlan(const QVSStlsInput &in_)
+  : ResourcePlan(static_cast<const QstlsInput&>(in_)) {
+  nStatePoints = 9;
+  nFixed = 3;
+}
+
+// Set the number of MPI processes
+void ResourcePlan::setRanks(const int nRanks_,
+			    const int nNodeRanks_) {
+  if (nRanks_ <= 0 || nNodeRanks_ <= 0) {
+    MPI::throwError("The number of processes must be larger than zero");
+  }
+  if (nNodeRanks_ > nRanks_) {
+    MPI::throwError("The number of processes on each node can't be larger"
+		    " than the total number of processes");
+  }
+  nRanks = nRanks_;
+  nNodeRanks = nNodeRanks_;
+}
+
+// Time the integrals of the fixed component. For each of the nRows
+// wave-vectors only a sample of the integrals is computed, all the
+// matsubara frequencies are included
+void ResourcePlan::calibrate(const int nRows) {
+  constexpr size_t maxSampleSize = 16;
+  if (nRows <= 0) {
+    MPI::throwError("The number of wave-vectors used to estimate the run"
+		    " time must be larger than zero");
+  }
+  const double Theta = in.getDegeneracy();
+  if (!isQuantum || Theta == 0.0) {
+    MPI::throwError("The run time can be estimated only for the quantum"
+		    " schemes at finite temperature");
+  }
+  const vector<double> wvg = Rpa::buildWvGrid(in);
+  ChemicalPotential mu(Theta);
+  mu.compute(in.getChemicalPotentialGuess());
+  const bool segregatedItg = in.getInt2DScheme() == "segregated";
+  const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
+  const size_t nSample = min(nx, maxSampleSize);
+  const size_t nRowsSample = min(static_cast<size_t>(nRows), nx - 1);
+  Integrator2D itg(in.getIntError());
+  double time = 0.0;
+  size_t nItg = 0;
+  for (size_t k = 0; k < nRowsSample; ++k) {
+    const double x = wvg[1 + ((2 * k + 1) * (nx - 1)) / (2 * nRowsSample)];
+    vector<double> sample;
+    for (size_t j = 0; j < nSample; ++j) {
+      sample.push_back(wvg[(j * (nx - 1)) / (nSample - 1)]);
+    }
+    if (find(sample.begin(), sample.end(), x) == sample.end()) {
+      sample.insert(upper_bound(sample.begin(), sample.end(), x), x);
+    }
+    Vector3D res(sample.size(), nl, sample.size());
+    AdrFixed adrTmp(Theta, wvg.front(), wvg.back(), x, mu.get(), itgGrid, itg);
+    const double tStart = MPI::timer();
+    adrTmp.get(sample, res);
+    time += MPI::timer() - tStart;
+    nItg += nl * sample.size();
+  }
+  itgTime = time / nItg;
+}
+
+// Size of the header of the files with the fixed component
+size_t ResourcePlan::getFixedHeaderSize() const {
+  return 2 * sizeof(int) + sizeof(double) + nx * sizeof(double);
+}
+
+// Memory for the arrays of one state point: ideal density response
+// (plus auxiliary density response for the quantum schemes) and a few
+// arrays defined on the wave-vector grid
+size_t ResourcePlan::getStatePointMemory() const {
+  size_t n2D = 1;
+  if (isQuantum) { n2D += (useIet) ? 3 : 1; }
+  return (n2D * nx * nl + 10 * nx) * sizeof(double);
+}
+
+// Memory for the low-rank representation of the fixed component,
+// assuming that it is not larger than the full matrix, and for the
+// decomposition of one frequency on each thread
+size_t ResourcePlan::getFixedMemory() const {
+  if (!isQuantum || !useLowRank) { return 0; }
+  return (nFixed * nl * nx * nx + 3 * nThreads * nx * nx) * sizeof(double);
+}
+
+// Memory for the fixed components of the iet schemes: each thread
+// uses the fixed component of one wave-vector and the reader keeps
+// two more for each thread, the 2D interpolators of each thread store
+// sixteen coefficients for each grid cell plus the derivatives
+size_t ResourcePlan::getFixedIetMemory() const {
+  if (!useIet) { return 0; }
+  return (3 * nThreads * nl * nx * nx + 19 * nThreads * nx * nx) * sizeof(double);
+}
+
+// Peak memory
+size_t ResourcePlan::getMemoryPerRank() const {
+  return nStatePoints * getStatePointMemory() + getFixedMemory() + getFixedIetMemory();
+}
+
+// The fixed components are stored only once on each node
+size_t ResourcePlan::getMemoryPerNode() const {
+  const size_t shared = (isQuantum) ? nFixed * nx * nl * nx * sizeof(double) : 0;
+  return shared + nNodeRanks * getMemoryPerRank();
+}
+
+// Disk space for the files with the fixed component. The files of the
+// iet schemes are counted at full size even if the low-rank
+// representation is used (the low-rank factors are always written in
+// double precision)
+size_t ResourcePlan::getFixedDiskUsage() const {
+  size_t out = 0;
+  if (computeFixed) {
+    out += nFixed * (getFixedHeaderSize() + nx * nl * nx * fixedElementSize);
+  }
+  if (computeFixedIet) {
+    const size_t rankMarkers = (useLowRank) ? nl * sizeof(int) : 0;
+    const size_t elementSize = (useLowRank) ? sizeof(double) : fixedElementSize;
+    out += nx * (getFixedHeaderSize() + rankMarkers + nl * nx * nx * elementSize);
+  }
+  return out;
+}
+
+// Disk space for the checkpoints written while the fixed component is
+// computed (removed when the fixed component is complete)
+size_t ResourcePlan::getCheckpointDiskUsage() const {
+  if (!computeFixed) { return 0; }
+  return nFixed * nx * (sizeof(int) + nl * nx * sizeof(double));
+}
+
+// Number of integrals
+size_t ResourcePlan::getIdrIntegrals() const {
+  return nStatePoints * nx * nl;
+}
+
+size_t ResourcePlan::getFixedIntegrals() const {
+  if (!computeFixed) { return 0; }
+  return nFixed * (nx - 1) * nl * nx;
+}
+
+size_t ResourcePlan::getFixedIetIntegrals() const {
+  if (!computeFixedIet) { return 0; }
+  return (nx - 1) * nl * (nx - 1) * nx;
+}
+
+// Run time for the fixed component
+double ResourcePlan::getFixedRunTime() const {
+  const size_t nItg = getFixedIntegrals();
+  if (nItg == 0) { return 0.0; }
+  return nItg * itgTime / (nRanks * nThreads);
+}
+
+// Print info on screen
+void ResourcePlan::print() const {
+  if (!MPI::isRoot()) {
+    return;
+  }
+  constexpr double MB = 1024.0 * 1024.0;
+  cout << "Size of the wave-vector grid = " << nx << endl;
+  cout << "Number of processes (total, per node) = " << nRanks << ","
+       << nNodeRanks << endl;
+  cout << "Peak memory per process (MB) = " << getMemoryPerRank() / MB << endl;
+  cout << "Peak memory per node (MB) = " << getMemoryPerNode() / MB << endl;
+  cout << "Disk space for the fixed component (MB) = "
+       << getFixedDiskUsage() / MB << endl;
+  cout << "Disk space for the checkpoints (MB) = "
+       << getCheckpointDiskUsage() / MB << endl;
+  cout << "Integrals for the ideal density response = " << getIdrIntegrals() << endl;
+  cout << "Integrals for the fixed component = " << getFixedIntegrals() << endl;
+  cout << "Integrals for the fixed component (iet) = "
+       << getFixedIetIntegrals() << endl;
+  if (!isnan(getFixedRunTime())) {
+    cout << "Run time for the fixed component (s) = "
+	 << getFixedRunTime() << endl;
+  }
+}
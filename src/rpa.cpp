@@ -1,3 +1,6 @@
+#include <complex>
+#include <deque>
+#include <mutex>
 #include "util.hpp"
 #include "numerics.hpp"
 #include "input.hpp"
@@ -14,9 +17,11 @@ using ItgType = Integrator1D::Type;
 Rpa::Rpa(const RpaInput &in_,
 	 const bool verbose_) : in(in_),
 				verbose(verbose_ && MPI::isRoot()),
+				comm(MPI::getCommunicator()),
+				distributed(true),
 				itg(ItgType::DEFAULT, in_.getIntError()) {
   // Assemble the wave-vector grid
-  buildWvGrid();
+  wvg = buildWvGrid(in);
   // Allocate arrays to the correct size
   const size_t nx = wvg.size();
   const size_t nl = in.getNMatsubara();
@@ -24,10 +29,12 @@ Rpa::Rpa(const RpaInput &in_,
   slfc.resize(nx);
   ssf.resize(nx);
   ssfHF.resize(nx);
+  wp.resize(nx, numUtil::NaN);
 }
 
 // Compute scheme
 int Rpa::compute(){
+  MPI::CommunicatorScope commScope(comm);
   try {
     init();
     if (verbose) cout << "Structural properties calculation ..." << endl;
@@ -48,6 +55,16 @@ int Rpa::compute(){
 
 // Initialize basic properties
 void Rpa::init(){
+  // These properties do not depend on the coupling parameter and are
+  // shared by all the schemes solved with the same degeneracy parameter
+  const bool useCache = in.getDegeneracy() > 0.0;
+  const auto cached = (useCache) ? RpaInitCache::get(in, wvg) : nullptr;
+  if (cached) {
+    mu = cached->mu;
+    idr = cached->idr;
+    ssfHF = cached->ssfHF;
+    return;
+  }
   if (verbose) cout << "Computing chemical potential: "; 
   computeChemicalPotential();
   if (verbose) cout << "Done" << endl;
@@ -57,20 +74,22 @@ void Rpa::init(){
   if (verbose) cout << "Computing HF static structure factor: "; 
   computeSsfHF();
   if (verbose) cout << "Done" << endl;
+  if (useCache) { RpaInitCache::add(in, wvg, {mu, idr, ssfHF}); }
 }
 
 
 // Set up wave-vector grid
-void Rpa::buildWvGrid(){
-  wvg.push_back(0.0);
-  const double dx = in.getWaveVectorGridRes();
-  const double xmax = in.getWaveVectorGridCutoff();
+vector<double> Rpa::buildWvGrid(const RpaInput &in_){
+  vector<double> wvg_ = {0.0};
+  const double dx = in_.getWaveVectorGridRes();
+  const double xmax = in_.getWaveVectorGridCutoff();
   if (xmax < dx) {
     MPI::throwError("The wave-vector grid cutoff must be larger than the resolution");
   }
-  while(wvg.back() < xmax){
-    wvg.push_back(wvg.back() + dx);
+  while(wvg_.back() < xmax){
+    wvg_.push_back(wvg_.back() + dx);
   }
+  return wvg_;
 }
 
 // Compute chemical potential
@@ -146,17 +165,35 @@ void Rpa::computeSsfFinite(){
 // Compute static structure factor at zero temperature
 void Rpa::computeSsfGround(){
   const double rs = in.getCoupling();
+  // Accuracy of the current iteration (see Stls::getIterationIntError)
+  const double intError = itg.getAccuracy();
   const size_t nx = wvg.size();
   assert(slfc.size() == nx);
   assert(ssf.size() == nx);
-  for (size_t i=0; i<nx; ++i){
+  // The plasmon frequencies from the previous call are used as
+  // initial guess for the search of the plasmon frequency
+  const vector<double> wpOld = wp;
+  // Quadrature rule shared among all wave-vectors
+  const GaussLegendre gl(16);
+  auto loopFunc = [&](int i)->void{
     const double x = wvg[i];
     double yMin = 0.0;
     if (x > 2.0) yMin = x * (x - 2.0);
     const double yMax = x * (x + 2.0);
-    SsfGround ssfTmp(x, rs, ssfHF[i], slfc[i], yMin, yMax, itg);
+    double wpGuess = wpOld[i];
+    if (isnan(wpGuess) && i > 0) wpGuess = wpOld[i-1];
+    Integrator1D itgTmp(intError);
+    SsfGround ssfTmp(x, rs, ssfHF[i], slfc[i], yMin, yMax, wpGuess, gl, itgTmp);
     ssf[i] = ssfTmp.get();
+    wp[i] = ssfTmp.getPlasmonFrequency();
+  };
+  if (!distributed) {
+    for (size_t i = 0; i < nx; ++i) { loopFunc(i); }
+    return;
   }
+  const auto& loopData = MPI::parallelFor(loopFunc, nx, in.getNThreads());
+  MPI::gatherLoopData(ssf.data(), loopData, 1);
+  MPI::gatherLoopData(wp.data(), loopData, 1);
 }
 
 // Compute static local field correction
@@ -198,6 +235,65 @@ double Rpa::getUInt() const {
 };  
 
 
+// -----------------------------------------------------------------
+// RpaInitCache class
+// -----------------------------------------------------------------
+
+// Input parameters that determine the cached data
+struct RpaInitKey {
+  double Theta;
+  int nl;
+  double intError;
+  vector<double> muGuess;
+  vector<double> wvg;
+  bool operator==(const RpaInitKey& other) const {
+    return Theta == other.Theta && nl == other.nl
+      && intError == other.intError && muGuess == other.muGuess
+      && wvg == other.wvg;
+  }
+};
+
+using RpaInitCacheEntry = pair<RpaInitKey, shared_ptr<const RpaInitCache::Data>>;
+
+// Maximum number of entries in the cache (the oldest entries are
+// removed first)
+static constexpr size_t rpaInitCacheSize = 16;
+static mutex rpaInitCacheMutex;
+
+static deque<RpaInitCacheEntry>& getRpaInitCache() {
+  static deque<RpaInitCacheEntry> cache;
+  return cache;
+}
+
+static RpaInitKey getRpaInitKey(const RpaInput &in,
+				const vector<double> &wvg) {
+  return RpaInitKey{in.getDegeneracy(), in.getNMatsubara(), in.getIntError(),
+		    in.getChemicalPotentialGuess(), wvg};
+}
+
+shared_ptr<const RpaInitCache::Data> RpaInitCache::get(const RpaInput &in,
+						       const vector<double> &wvg) {
+  const RpaInitKey key = getRpaInitKey(in, wvg);
+  lock_guard<mutex> lock(rpaInitCacheMutex);
+  for (const auto& entry : getRpaInitCache()) {
+    if (entry.first == key) { return entry.second; }
+  }
+  return nullptr;
+}
+
+void RpaInitCache::add(const RpaInput &in,
+		       const vector<double> &wvg,
+		       const Data &data) {
+  const RpaInitKey key = getRpaInitKey(in, wvg);
+  lock_guard<mutex> lock(rpaInitCacheMutex);
+  auto& cache = getRpaInitCache();
+  for (const auto& entry : cache) {
+    if (entry.first == key) { return; }
+  }
+  if (cache.size() == rpaInitCacheSize) { cache.pop_front(); }
+  cache.push_back(RpaInitCacheEntry(key, make_shared<const Data>(data)));
+}
+
 // -----------------------------------------------------------------
 // Idr class
 // -----------------------------------------------------------------
@@ -261,54 +357,76 @@ vector<double> Idr::get() const {
 // IdrGround class
 // -----------------------------------------------------------------
 
+// Contributions of y = x/2 + Omega/(2x) and y = x/2 - Omega/(2x) to
+// the real and imaginary part at zero temperature (shared by re0, im0
+// and get0)
+static inline double idrGroundReTerm(const double& y) {
+  if (y == 1.0 || y == -1.0) { return 0.0; }
+  return (1.0 - y*y) * log(abs((y + 1.0)/(y - 1.0)));
+}
+
+static inline double idrGroundImTerm(const double& y) {
+  const double y2 = y*y;
+  return (y2 < 1.0) ? 1.0 - y2 : 0.0;
+}
+
 // Real part at zero temperature
 double IdrGround::re0() const {
-  double adder1 = 0.0;
-  double adder2 = 0.0;
-  double preFactor = 0.0;
-  if (x > 0.0) {
-    double x_2 = x/2.0;
-    double Omega_2x = Omega/(2.0*x);
-    double sumFactor = x_2 + Omega_2x;
-    double diffFactor = x_2 - Omega_2x;
-    double sumFactor2 = sumFactor*sumFactor;
-    double diffFactor2 = diffFactor*diffFactor;
-    preFactor = 0.5;
-    if (sumFactor != 1.0) {
-      double log_sum_arg = (sumFactor + 1.0)/(sumFactor - 1.0);
-      if (log_sum_arg < 0.0) log_sum_arg = -log_sum_arg;
-      adder1 = 1.0/(4.0*x)*(1.0 - sumFactor2)*log(log_sum_arg);
-    }
-    if (diffFactor != 1.0 && diffFactor != -1.0) {
-      double log_diff_arg = (diffFactor + 1.0)/(diffFactor - 1.0);
-      if (log_diff_arg < 0.0) log_diff_arg = -log_diff_arg;
-      adder2 = 1.0/(4.0*x)*(1.0 - diffFactor2)*log(log_diff_arg);
-    }
-  }
-  return preFactor + adder1 + adder2;
+  if (x <= 0.0) return 0.0;
+  const double sumFactor = x/2.0 + Omega/(2.0*x);
+  const double diffFactor = x/2.0 - Omega/(2.0*x);
+  return 0.5 + (idrGroundReTerm(sumFactor) + idrGroundReTerm(diffFactor))/(4.0*x);
 }
 
 // Imaginary part at zero temperature
 double IdrGround::im0() const {
-  double preFactor = 0.0;
-  double adder1 = 0.0;
-  double adder2 = 0.0;
-  if (x > 0.0) {
-    double x_2 = x/2.0;
-    double Omega_2x = Omega/(2.0*x);
-    double sumFactor = x_2 + Omega_2x;
-    double diffFactor = x_2 - Omega_2x;
-    double sumFactor2 = sumFactor*sumFactor;
-    double diffFactor2 = diffFactor*diffFactor;
-    preFactor = -M_PI/(4.0*x);
-    if (sumFactor2 < 1.0) {
-      adder1 = 1 - sumFactor2;
-    }
-    if (diffFactor2 < 1.0) {
-      adder2 = 1 - diffFactor2;
+  if (x <= 0.0) return 0.0;
+  const double sumFactor = x/2.0 + Omega/(2.0*x);
+  const double diffFactor = x/2.0 - Omega/(2.0*x);
+  return -M_PI/(4.0*x) * (idrGroundImTerm(sumFactor) - idrGroundImTerm(diffFactor));
+}
+
+// Result at zero temperature for the imaginary frequency i*Omega
+double IdrGround::imagFreq0() const {
+  if (x == 0.0) return (Omega == 0.0) ? 1.0 : 0.0;
+  const complex<double> s(x/2.0, Omega/(2.0*x));
+  if (abs(s) > 10.0) {
+    // Asymptotic expansion (avoids cancellations for large |s|)
+    const complex<double> sInv2 = 1.0/(s*s);
+    complex<double> sInv = 1.0/s;
+    complex<double> res = 0.0;
+    for (int m = 0; m < 10; ++m) {
+      res += 4.0 * sInv / ((2.0*m + 1.0) * (2.0*m + 3.0));
+      sInv *= sInv2;
     }
+    return res.real()/(2.0*x);
+  }
+  if (s == 1.0) return 0.5;
+  return 0.5 + ((1.0 - s*s) * log((s + 1.0)/(s - 1.0))).real()/(2.0*x);
+}
+
+// Real and imaginary part at zero temperature for a set of
+// frequencies. The terms that depend only on the wave-vector are
+// computed once and the loop over the frequencies has no branches
+// other than the selections in the helper functions
+void IdrGround::get0(const double& x,
+		     const vector<double>& Omega,
+		     vector<double>& re,
+		     vector<double>& im) {
+  const size_t n = Omega.size();
+  re.assign(n, 0.0);
+  im.assign(n, 0.0);
+  if (x <= 0.0) { return; }
+  const double x_2 = x/2.0;
+  const double inv2x = 1.0/(2.0*x);
+  const double inv4x = 1.0/(4.0*x);
+  const double preFactorIm = -M_PI/(4.0*x);
+  for (size_t i = 0; i < n; ++i) {
+    const double sumFactor = x_2 + Omega[i]*inv2x;
+    const double diffFactor = x_2 - Omega[i]*inv2x;
+    re[i] = 0.5 + (idrGroundReTerm(sumFactor) + idrGroundReTerm(diffFactor))*inv4x;
+    im[i] = preFactorIm * (idrGroundImTerm(sumFactor) - idrGroundImTerm(diffFactor));
   }
-  return preFactor * (adder1 - adder2);
 }
 
 // Frequency derivative of the real part at zero temperature
@@ -400,14 +518,53 @@ double Ssf::get() const {
 // -----------------------------------------------------------------
 
 // Get result of integration
-double SsfGround::get() const {
+double SsfGround::get() {
   if (x == 0.0) return 0.0;
   if (rs == 0.0) return ssfHF;
+  const double ssfC = integral();
+  const double ssfP = plasmon();
+  return ssfHF + ssfC + ssfP;
+}
+
+// Integral over the particle-hole continuum. The integral is first
+// computed with a fixed order quadrature rule, splitting the
+// integration domain at the point where the imaginary part of the
+// ideal density response has a kink. The quadrature is repeated
+// after halving each sub-interval and, if the two results do not
+// agree within the required accuracy, an adaptive integration
+// scheme is used instead
+double SsfGround::integral() const {
+  vector<double> limits = {yMin};
+  if (x < 2.0) { limits.push_back(x * (2.0 - x)); }
+  limits.push_back(yMax);
+  // Nodes and weights for all sub-intervals (coarse and fine)
+  vector<double> Omega;
+  vector<double> wCoarse;
+  vector<double> wFine;
+  for (size_t i = 0; i < limits.size() - 1; ++i) {
+    const double a = limits[i];
+    const double b = limits[i+1];
+    const double c = 0.5 * (a + b);
+    gl.map(a, b, Omega, wCoarse);
+    wFine.resize(wCoarse.size(), 0.0);
+    gl.map(a, c, Omega, wFine);
+    gl.map(c, b, Omega, wFine);
+    wCoarse.resize(wFine.size(), 0.0);
+  }
+  // Evaluate the integrand on all nodes at once
+  vector<double> f;
+  integrand(Omega, f);
+  double coarse = 0.0;
+  double fine = 0.0;
+  for (size_t i = 0; i < f.size(); ++i) {
+    coarse += wCoarse[i] * f[i];
+    fine += wFine[i] * f[i];
+  }
+  if (abs(fine - coarse) <= itg.getAccuracy() * abs(fine)) { return fine; }
+  // Fall back to adaptive integration
   auto func = [&](const double& y)->double{return integrand(y);};
   itg.compute(func, ItgParam(yMin, yMax));
-  double ssfP;
-  ssfP = plasmon();
-  return ssfHF + itg.getSolution() + ssfP;
+  return itg.getSolution();
 }
 
 // Integrand for zero temperature calculations
@@ -424,6 +581,22 @@ double SsfGround::integrand(const double& Omega) const {
   return 1.5/(M_PI)* idrIm * (1.0/(factRe2 + factIm2) - 1.0);
 }
 
+void SsfGround::integrand(const vector<double>& Omega,
+			  vector<double>& res) const {
+  const double fact = (4.0 * lambda * rs)/(M_PI * x * x) * (1 - slfc);
+  vector<double> idrRe;
+  vector<double> idrIm;
+  IdrGround::get0(x, Omega, idrRe, idrIm);
+  res.resize(Omega.size());
+  for (size_t i = 0; i < Omega.size(); ++i) {
+    const double factRe = 1 + fact * idrRe[i];
+    const double factIm = fact * idrIm[i];
+    const double factRe2 = factRe * factRe;
+    const double factIm2 = factIm * factIm;
+    res[i] = 1.5/(M_PI)* idrIm[i] * (1.0/(factRe2 + factIm2) - 1.0);
+  }
+}
+
 // NOTE: At the plasmon frequency, the imaginary part of the ideal
 // density response is zero. Hence, all the following definitions
 // for the dielectric function are constructed with the assumption
@@ -433,32 +606,64 @@ double SsfGround::integrand(const double& Omega) const {
 // valid
 
 // Plasmon contribution to the static structure factor
-double SsfGround::plasmon() const {
-  // Look for a region where the dielectric function changes sign
-  bool search_root = false;
-  const double wCo = x*x + 2*x;
-  const double dw = wCo;
-  const double wLo = wCo;
+double SsfGround::plasmon() {
+  double wLo;
   double wHi;
-  const int signLo = (drf(wLo) >= 0) ? 1 : -1;
-  for (size_t i=1; i<1000; i++) {
-    wHi = wLo + dw * i;
-    const double signHi = (drf(wHi) >= 0) ? 1 : -1;;
-    if (signHi != signLo) {
-      search_root = true;
-      break;
-    }
-  }
   // Return if no root can be found
-  if (!search_root) return 0;
+  if (!bracketPlasmon(wLo, wHi)) return 0;
   // Compute plasmon frequency
   auto func = [this](const double& Omega)->double{return drf(Omega);};
   const double guess[] = {wLo, wHi};
   BrentRootSolver rsol;
   rsol.solve(func, vector<double>(begin(guess),end(guess)));
+  wp = rsol.getSolution();
   // Output
   const double fact = (4.0 *lambda *rs)/(M_PI * x * x);
-  return 1.5 / (fact * abs(drfDer(rsol.getSolution())));
+  return 1.5 / (fact * abs(drfDer(wp)));
+}
+
+// Look for a region where the dielectric function changes sign. The
+// search starts from the initial guess for the plasmon frequency (or
+// from the long wavelength limit of the plasmon dispersion if no
+// guess is available) and proceeds with steps of increasing size
+bool SsfGround::bracketPlasmon(double& wLo,
+			       double& wHi) const {
+  const double wCo = x*x + 2*x;
+  const double wMin = wCo;
+  const double wMax = 1000 * wCo;
+  const int signMin = (drf(wMin) >= 0) ? 1 : -1;
+  auto sign = [&](const double& Omega)->int{
+    return (drf(Omega) >= 0) ? 1 : -1;
+  };
+  double w = wpGuess;
+  if (isnan(w)) {
+    const double wp0 = 2.0 * lambda * lambda * sqrt(3.0 * rs);
+    w = sqrt(wp0 * wp0 + 2.4 * x * x + x * x * x * x);
+  }
+  if (w <= wMin || w >= wMax) { w = wMin + wCo; }
+  double dw = 1e-3 * w;
+  if (sign(w) == signMin) {
+    // The root is above the initial guess
+    wLo = w;
+    wHi = w;
+    while (wHi < wMax) {
+      wHi = min(wLo + dw, wMax);
+      if (sign(wHi) != signMin) { return true; }
+      wLo = wHi;
+      dw *= 2.0;
+    }
+    return false;
+  }
+  // The root is below the initial guess
+  wHi = w;
+  wLo = w;
+  while (wLo > wMin) {
+    wLo = max(wHi - dw, wMin);
+    if (wLo == wMin || sign(wLo) == signMin) { return true; }
+    wHi = wLo;
+    dw *= 2.0;
+  }
+  return true;
 }
 
 // Dielectric response function
@@ -20,7 +20,11 @@ Stls::Stls(const StlsInput& in_,
 	   const bool verbose_,
 	   const bool writeFiles_) : Rpa(in_, verbose_),
 				     in(in_),
-				     writeFiles(writeFiles_ && MPI::isRoot()) {
+				     writeFiles(writeFiles_ && MPI::isRoot()),
+				     counter(0),
+				     residual(1.0),
+				     itgError(in_.getIntError()),
+				     stopped(false) {
   // Check if iet scheme should be solved
   useIet = in.getTheory() == "STLS-HNC"
     || in.getTheory() == "STLS-IOI"
@@ -42,6 +46,7 @@ Stls::Stls(const StlsInput& in_,
 }
 
 int Stls::compute(){
+  MPI::CommunicatorScope commScope(comm);
   try {
     init();
     if (verbose) cout << "Structural properties calculation ..." << endl;
@@ -55,6 +60,39 @@ int Stls::compute(){
   }
 }
 
+// Initialize the scheme for a step-wise solution
+int Stls::initialize(){
+  MPI::CommunicatorScope commScope(comm);
+  try {
+    init();
+    initialGuess();
+    counter = 0;
+    residual = 1.0;
+    itgError = in.getIntError();
+    stopped = false;
+    return 0;
+  }
+  catch (const runtime_error& err) {
+    cerr << err.what() << endl;
+    return 1;
+  }
+}
+
+// Perform (at most) nIter iterations of the scheme
+int Stls::step(const int nIter){
+  MPI::CommunicatorScope commScope(comm);
+  try {
+    for (int i = 0; i < nIter && !isIterationDone(); ++i) {
+      doIteration();
+    }
+    return 0;
+  }
+  catch (const runtime_error& err) {
+    cerr << err.what() << endl;
+    return 1;
+  }
+}
+
 // Initialize basic properties
 void Stls::init(){
   Rpa::init();
@@ -84,7 +122,7 @@ void Stls::computeSlfcStls() {
 }
 
 void Stls::computeSlfcIet() {
-  Integrator2D itg2(in.getIntError());
+  Integrator2D itg2(itgError);
   const bool segregatedItg = in.getInt2DScheme() == "segregated";
   const vector<double> itgGrid = (segregatedItg) ? wvg : vector<double>();
   const Interpolator1D ssfItp(wvg, ssf);
@@ -102,8 +140,10 @@ void Stls::computeBf() {
   const size_t nx = wvg.size();
   Integrator1D itgF(ItgType::FOURIER, 1e-10);
   assert(bf.size() == nx);
+  const auto theory = BridgeFunction::getTheory(in.getTheory());
+  const auto mapping = BridgeFunction::getMapping(in.getIETMapping());
   for (size_t i=0; i<nx; ++i){ 
-    BridgeFunction bfTmp(in.getTheory(), in.getIETMapping(),
+    BridgeFunction bfTmp(theory, mapping,
 			 in.getCoupling(), in.getDegeneracy(),
 			 wvg[i], itgF);
     bf[i] = bfTmp.get();
@@ -112,37 +152,75 @@ void Stls::computeBf() {
 
 // stls iterations
 void Stls::doIterations() {
-  const int maxIter = in.getNIter();
-  const int outIter = in.getOutIter();
-  const double minErr = in.getErrMin();
-  double err = 1.0;
-  int counter = 0;
   // Define initial guess
   initialGuess();
-  while (counter < maxIter+1 && err > minErr ) {
-    // Start timing
-    double tic = MPI::timer();
-    // Update static structure factor
-    computeSsf();
-    // Update static local field correction
-    computeSlfc();
-    // Update diagnostic
-    counter++;
-    err = computeError();
-    // Update solution
-    updateSolution();
-    // Write output
-    if (counter % outIter == 0 && writeFiles) { writeRecovery(); }
-    // End timing
-    double toc = MPI::timer();
-    // Print diagnostic
-    if (verbose) {
-       printf("--- iteration %d ---\n", counter);
-       printf("Elapsed time: %f seconds\n", toc - tic);
-       printf("Residual error: %.5e\n", err);
-       fflush(stdout);
-    }
+  counter = 0;
+  residual = 1.0;
+  itgError = in.getIntError();
+  stopped = false;
+  while (!isIterationDone()) {
+    doIteration();
+  }
+}
+
+// Single stls iteration
+void Stls::doIteration() {
+  const int outIter = in.getOutIter();
+  // Start timing
+  double tic = MPI::timer();
+  // Set the accuracy of the integrals
+  itgError = getIterationIntError();
+  itg.setAccuracy(itgError);
+  // Update static structure factor
+  computeSsf();
+  // Update static local field correction
+  computeSlfc();
+  itg.setAccuracy(in.getIntError());
+  // Update diagnostic
+  counter++;
+  residual = computeError();
+  // Update solution
+  updateSolution();
+  // Write output
+  if (counter % outIter == 0 && writeFiles) { writeRecovery(); }
+  // End timing
+  double toc = MPI::timer();
+  // Print diagnostic
+  if (verbose) {
+    printf("--- iteration %d ---\n", counter);
+    printf("Elapsed time: %f seconds\n", toc - tic);
+    printf("Residual error: %.5e\n", residual);
+    fflush(stdout);
+  }
+  // Notify the callback
+  callCallback();
+}
+
+// Check if the iterations should be stopped
+bool Stls::isIterationDone() const {
+  return stopped || counter >= in.getNIter() + 1 || isConverged();
+}
+
+// Accuracy of the integrals for the next iteration. The accuracy is
+// relaxed proportionally to the residual error in the first iterations
+// and it is set back to the input accuracy once the residual error is
+// small enough to stop the iterations
+double Stls::getIterationIntError() const {
+  const double intError = in.getIntError();
+  const double scaling = in.getIntErrorScaling();
+  if (scaling == 0.0 || residual <= in.getErrMin()) { return intError; }
+  return max(intError, scaling * residual);
+}
+
+// Call the iteration callback (if any)
+void Stls::callCallback() {
+  if (!callback) { return; }
+  const int proceed = callback(counter, residual) ? 1 : 0;
+  if (!MPI::isEqualOnAllRanks(proceed)) {
+    MPI::throwError("The iteration callback returned different"
+		    " values on different ranks");
   }
+  stopped = (proceed == 0);
 }
 
 // Initial guess for stls iterations
@@ -303,18 +381,33 @@ double SlfcIet::integrand2(const double& w) const {
 // BridgeFunction class
 // -----------------------------------------------------------------
 
-double BridgeFunction::get() const {
-  if (theory == "STLS-HNC" || theory == "QSTLS-HNC") { return hnc(); }
-  if (theory == "STLS-IOI" || theory == "QSTLS-IOI") { return ioi(); }
-  if (theory == "STLS-LCT" || theory == "QSTLS-LCT") { return lct(); }
+BridgeFunction::Theory BridgeFunction::getTheory(const string& theory) {
+  if (theory == "STLS-HNC" || theory == "QSTLS-HNC") { return HNC; }
+  if (theory == "STLS-IOI" || theory == "QSTLS-IOI") { return IOI; }
+  if (theory == "STLS-LCT" || theory == "QSTLS-LCT") { return LCT; }
   MPI::throwError("Unknown theory to compute the bridge function term");
+  return HNC;
+}
+
+BridgeFunction::Mapping BridgeFunction::getMapping(const string& mapping) {
+  if (mapping == "sqrt") { return SQRT; }
+  if (mapping == "linear") { return LINEAR; }
+  return STANDARD;
+}
+
+double BridgeFunction::get() const {
+  switch (theory) {
+  case HNC: return hnc();
+  case IOI: return ioi();
+  case LCT: return lct();
+  }
   return numUtil::Inf;
 }
 
 double BridgeFunction::couplingParameter() const {
   const double fact = 2 * lambda * lambda * rs;
-  if (mapping == "sqrt") { return fact/sqrt(1 + Theta * Theta); }
-  if (mapping == "linear") { return fact/(1 + Theta); }
+  if (mapping == SQRT) { return fact/sqrt(1 + Theta * Theta); }
+  if (mapping == LINEAR) { return fact/(1 + Theta); }
   if (Theta != 0.0) { return fact/Theta; }
   MPI::throwError("The standard iet mapping cannot be used in the "
 		      "ground state");
@@ -1,16 +1,22 @@
 #define OMPI_SKIP_MPICXX 1 // Disable MPI-C++ bindings
 
 #include <numeric>
+#include <map>
+#include <deque>
+#include <cstdlib>
+#include <atomic>
+#include <array>
 #include <omp.h>
 #include <mpi.h>
+#include <sys/mman.h>
 #include <boost/python.hpp>
 #include <boost/python/numpy.hpp>
+#include <fmt/core.h>
 #include "numerics.hpp"
 #include "util.hpp"
 
 using namespace std;
 using ItgParam = Integrator1D::Param;
-using ItgType = Integrator1D::Type;
 
 namespace numUtil {
 
@@ -102,6 +108,65 @@ namespace vecUtil {
    std::for_each(v.begin(), v.end(), [&](double &vi){ vi = num;}); 
   }
   
+  // Huge pages are assumed to be 2 MB (the default on x86-64 and on
+  // most aarch64 systems)
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+  static constexpr size_t HUGE_PAGE_SIZE = 2 << 20;
+  
+  void* allocateAligned(const size_t bytes) {
+    if (bytes == 0) { return nullptr; }
+    const bool huge = bytes >= HUGE_PAGE_SIZE;
+    const size_t alignment = (huge) ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE;
+    // The size passed to aligned_alloc must be a multiple of the alignment
+    const size_t size = ((bytes + alignment - 1) / alignment) * alignment;
+    void* ptr = std::aligned_alloc(alignment, size);
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+#ifdef MADV_HUGEPAGE
+    if (huge) { madvise(ptr, size, MADV_HUGEPAGE); }
+#endif
+    return ptr;
+  }
+
+  void freeAligned(void* ptr) {
+    std::free(ptr);
+  }
+  
+  // -----------------------------------------------------------------
+  // MatrixView class
+  // -----------------------------------------------------------------
+
+  size_t MatrixView::size(const size_t i) const {
+    assert(i == 0 || i == 1);
+    return (i == 0) ? s1 : s2;
+  }
+
+  const double& MatrixView::row(const size_t i) const {
+    assert(hasContiguousRows());
+    return operator()(i, 0);
+  }
+
+  MatrixView MatrixView::transpose() const {
+    return MatrixView(p, s2, s1, st2, st1);
+  }
+
+  MatrixView MatrixView::rows(const size_t i,
+			      const size_t n) const {
+    assert(i + n <= s1);
+    return MatrixView(p + i*st1, n, s2, st1, st2);
+  }
+
+  void MatrixView::copyTo(double* out) const {
+    if (isContiguous()) {
+      std::copy(p, p + size(), out);
+      return;
+    }
+    for (size_t i = 0; i < s1; ++i) {
+      for (size_t j = 0; j < s2; ++j) {
+	out[j + i*s2] = operator()(i, j);
+      }
+    }
+  }
+
   // -----------------------------------------------------------------
   // Vector2D class
   // -----------------------------------------------------------------
@@ -109,7 +174,7 @@ namespace vecUtil {
   Vector2D::Vector2D(const vector<vector<double>>& v_)  {
     s1 = v_.size();
     s2 = (s1 > 0) ? v_[0].size() : 0;
-    v = vector<double>(s1 * s2, 0.0);
+    v = AlignedVector(s1 * s2, 0.0);
     size_t cnt = 0;
     for (const auto& vi : v_) {
       assert(vi.size() == s2);
@@ -150,23 +215,27 @@ namespace vecUtil {
     return operator()(i,0);
   }
 
+  MatrixView Vector2D::view() const {
+    return MatrixView(v.data(), s1, s2);
+  }
+
   bool Vector2D::operator==(const Vector2D& other) const {
     return v == other.v && s1 == other.s1 && s2 == other.s2;
   }
   
-  vector<double>::iterator Vector2D::begin() {
+  AlignedVector::iterator Vector2D::begin() {
     return v.begin();
   }
 
-  vector<double>::iterator Vector2D::end() {
+  AlignedVector::iterator Vector2D::end() {
     return v.end();
   }
 
-  vector<double>::const_iterator Vector2D::begin() const {
+  AlignedVector::const_iterator Vector2D::begin() const {
     return v.begin();
   }
 
-  vector<double>::const_iterator Vector2D::end() const {
+  AlignedVector::const_iterator Vector2D::end() const {
     return v.end();
   }
   
@@ -194,17 +263,17 @@ namespace vecUtil {
   
   void Vector2D::sum(const Vector2D &v_) {
     assert(v_.size() == v.size());
-    v = vecUtil::sum(v, v_.v);
+    std::transform(v.begin(), v.end(), v_.v.begin(), v.begin(), plus<double>());
   }
 
   void Vector2D::diff(const Vector2D &v_) {
     assert(v_.size() == v.size());
-    v = vecUtil::diff(v, v_.v);
+    std::transform(v.begin(), v.end(), v_.v.begin(), v.begin(), minus<double>());
   }
 
   void Vector2D::mult(const Vector2D &v_) {
     assert(v_.size() == v.size());
-    v = vecUtil::mult(v, v_.v);
+    std::transform(v.begin(), v.end(), v_.v.begin(), v.begin(), multiplies<double>());
   }
 
   void Vector2D::mult(const double &num) {
@@ -213,13 +282,27 @@ namespace vecUtil {
 
   void Vector2D::div(const Vector2D &v_) {
     assert(v_.size() == v.size());
-    v = vecUtil::div(v, v_.v);
+    std::transform(v.begin(), v.end(), v_.v.begin(), v.begin(), divides<double>());
   }
 
   // -----------------------------------------------------------------
   // Vector3D class
   // -----------------------------------------------------------------
   
+  Vector3D::Vector3D(const Vector3D& other)
+    : v(other.begin(), other.end()), s1(other.s1), s2(other.s2), s3(other.s3) {;}
+
+  Vector3D& Vector3D::operator=(const Vector3D& other) {
+    if (this != &other) {
+      ext.reset();
+      v.assign(other.begin(), other.end());
+      s1 = other.s1;
+      s2 = other.s2;
+      s3 = other.s3;
+    }
+    return *this;
+  }
+
   size_t Vector3D::size() const {
     return s1*s2*s3;
   } 
@@ -232,12 +315,13 @@ namespace vecUtil {
   }
 
   bool Vector3D::empty() const {
-    return v.empty();
+    return size() == 0;
   }
 
   void Vector3D::resize(const size_t s1_,
 			const size_t s2_,
 			const size_t s3_) {
+    ext.reset();
     v.clear();
     s1 = s1_;
     s2 = s2_;
@@ -245,16 +329,32 @@ namespace vecUtil {
     v.resize(s1_*s2_*s3_, 0.0);
   }
 
+  void Vector3D::setStorage(const shared_ptr<double>& ext_,
+			    const size_t s1_,
+			    const size_t s2_,
+			    const size_t s3_) {
+    AlignedVector().swap(v);
+    ext = ext_;
+    s1 = s1_;
+    s2 = s2_;
+    s3 = s3_;
+  }
+
+  void Vector3D::share(const Vector3D& other) {
+    assert(other.hasExternalStorage());
+    setStorage(other.ext, other.s1, other.s2, other.s3);
+  }
+
   double& Vector3D::operator()(const size_t i,
 			       const size_t j,
 			       const size_t k) {
-    return v[k + j*s3 + i*s2*s3];
+    return ptr()[k + j*s3 + i*s2*s3];
   }
   
   const double& Vector3D::operator()(const size_t i,
 				     const size_t j,
 				     const size_t k) const {
-    return v[k + j*s3 + i*s2*s3];
+    return ptr()[k + j*s3 + i*s2*s3];
   }
 
   const double& Vector3D::operator()(const size_t i,
@@ -266,76 +366,85 @@ namespace vecUtil {
     return operator()(i, 0);
   }
 
+  MatrixView Vector3D::slice(const size_t dim,
+			     const size_t index) const {
+    assert(dim == 0 || dim == 1 || dim == 2);
+    assert(index < size(dim));
+    if (dim == 0) return MatrixView(&operator()(index, 0, 0), s2, s3, s3, 1);
+    if (dim == 1) return MatrixView(&operator()(0, index, 0), s1, s3, s2*s3, 1);
+    return MatrixView(&operator()(0, 0, index), s1, s2, s2*s3, s3);
+  }
+
   bool Vector3D::operator==(const Vector3D& other) const {
-    return v == other.v && s1 == other.s1
-      && s2 == other.s2 && s3 == other.s3;
+    return s1 == other.s1 && s2 == other.s2 && s3 == other.s3
+      && std::equal(begin(), end(), other.begin());
   }
   
-  vector<double>::iterator Vector3D::begin() {
-    return v.begin();
+  double* Vector3D::begin() {
+    return ptr();
   }
 
-  vector<double>::iterator Vector3D::end() {
-    return v.end();
+  double* Vector3D::end() {
+    return ptr() + size();
   }
 
-  vector<double>::const_iterator Vector3D::begin() const {
-    return v.begin();
+  const double* Vector3D::begin() const {
+    return ptr();
   }
 
-  vector<double>::const_iterator Vector3D::end() const {
-    return v.end();
+  const double* Vector3D::end() const {
+    return ptr() + size();
   }
 
   double* Vector3D::data() {
-    return v.data();
+    return ptr();
   }
 
   const double* Vector3D::data() const {
-    return v.data();
+    return ptr();
   }
   
   
   void Vector3D::fill(const double &num) {
-    std::for_each(v.begin(), v.end(), [&](double &vi){ vi = num;});
+    std::fill(begin(), end(), num);
   }
 
   void Vector3D::fill(const size_t i,
 		      const size_t j,
 		      const double &num) {
-    const auto &dest = v.begin() + j*s3 + i*s2*s3;
-    std::for_each(dest, dest + s3, [&](double &vi){ vi = num;});
+    double* dest = ptr() + j*s3 + i*s2*s3;
+    std::fill(dest, dest + s3, num);
   }
   
   void Vector3D::fill(const size_t i,
 		      const size_t j,
 		      const vector<double> &num) {
     assert(num.size() == s3);
-    std::copy(num.begin(), num.end(), v.begin() + j*s3 + i*s2*s3);
+    std::copy(num.begin(), num.end(), ptr() + j*s3 + i*s2*s3);
   }  
 
   void Vector3D::sum(const Vector3D &v_) {
-    assert(v_.size() == v.size());
-    v = vecUtil::sum(v, v_.v);
+    assert(v_.size() == size());
+    std::transform(begin(), end(), v_.begin(), begin(), plus<double>());
   }
 
   void Vector3D::diff(const Vector3D &v_) {
-    assert(v_.size() == v.size());
-    v = vecUtil::diff(v, v_.v);
+    assert(v_.size() == size());
+    std::transform(begin(), end(), v_.begin(), begin(), minus<double>());
   }
 
   void Vector3D::mult(const Vector3D &v_) {
-    assert(v_.size() == v.size());
-    v = vecUtil::mult(v, v_.v);
+    assert(v_.size() == size());
+    std::transform(begin(), end(), v_.begin(), begin(), multiplies<double>());
   }
 
   void Vector3D::mult(const double &num) {
-    std::for_each(v.begin(), v.end(), [&](double &vi){ vi *= num;});
+    std::for_each(begin(), end(), [&](double &vi){ vi *= num;});
   }
 
   void Vector3D::div(const Vector3D &v_) {
-    assert(v_.size() == v.size());
-    v = vecUtil::div(v, v_.v);
+    assert(v_.size() == size());
+    std::transform(begin(), end(), v_.begin(), begin(), divides<double>());
   }
 
   // -----------------------------------------------------------------
@@ -449,10 +558,8 @@ namespace thermoUtil {
   double computeInternalEnergy(const vector<double> &wvg,
 			       const vector<double> &ssf,
 			       const double &coupling) {
-    const Interpolator1D itp(wvg, ssf);
-    Integrator1D itg(1.0e-6);
-    const InternalEnergy uInt(coupling, wvg.front(), wvg.back(), itp, itg);
-    return uInt.get();
+    const InternalEnergy uInt(coupling, wvg);
+    return uInt.get(ssf);
   }
 
     
@@ -480,14 +587,11 @@ namespace thermoUtil {
 			    const vector<double> &wvg,
 			    const vector<double> &ssf) {
     assert(ssf.size() > 0 && wvg.size() > 0);
-    const Interpolator1D itp(wvg, ssf);
     const int nr = r.size();
     vector<double> rdf(nr);
-    Integrator1D itg(ItgType::DEFAULT, 1.0e-6);
-    Integrator1D itgf(ItgType::FOURIER, 1.0e-6);
     for (int i=0; i<nr; ++i){
-      const Rdf rdfTmp(r[i], wvg.back(), itp, itg, itgf);
-      rdf[i] = rdfTmp.get();
+      const Rdf rdfTmp(r[i], wvg);
+      rdf[i] = rdfTmp.get(ssf);
     }
     return rdf;
   }
@@ -495,19 +599,16 @@ namespace thermoUtil {
   // -----------------------------------------------------------------
   // InternalEnergy class
   // -----------------------------------------------------------------
-  
-  double InternalEnergy::ssf(const double& y) const {
-    return ssfi.eval(y);
-  }
-  
-  double InternalEnergy::integrand(const double& y) const {
-    return ssf(y) - 1;
-  }
 
-  double InternalEnergy::get() const  {
-    auto func = [&](const double& y)->double{return integrand(y);};
-    itg.compute(func, ItgParam(yMin, yMax));
-    return itg.getSolution()/(M_PI * rs * lambda);
+  // The internal energy is linear in ssf - 1 and is computed as a dot
+  // product with the weights that reproduce the integral of the spline
+  // interpolant of the static structure factor
+  InternalEnergy::InternalEnergy(const double& rs_,
+				 const vector<double> &wvg_)
+    : rs(rs_), functional(make_shared<const SplineFunctional>(wvg_)) { ; }
+  
+  double InternalEnergy::get(const vector<double> &ssf) const  {
+    return functional->eval(ssf, 1.0)/(M_PI * rs * lambda);
   }
 
   // -----------------------------------------------------------------
@@ -524,27 +625,29 @@ namespace thermoUtil {
   // -----------------------------------------------------------------
   // Rdf class
   // -----------------------------------------------------------------
-  
-  double Rdf::ssf(const double& y) const {
-    return ssfi.eval(y);
-  }
-
-  double Rdf::integrand(const double& y) const {
-    if (y > cutoff) return 0;
-    const double yssf = y * (ssf(y) - 1);
-    return (r == 0.0) ? y * yssf : yssf;
-  }
 
-  double Rdf::get() const {
-    auto func = [&](const double& y)->double{return integrand(y);};
-    if (r == 0) {
-      itg.compute(func, ItgParam(0.0, cutoff));
-      return 1 + 1.5 * itg.getSolution();
+  // The kernel of the Fourier transform is integrated exactly against
+  // the spline interpolant of the static structure factor. The number
+  // of quadrature nodes grows with the number of oscillations of the
+  // kernel in each interval of the wave-vector grid
+  Rdf::Rdf(const double& r,
+	   const vector<double> &wvg_) {
+    if (r == 0.0) {
+      auto kernel = [&](const double& y)->double{ return y * y; };
+      functional = make_shared<const SplineFunctional>(wvg_, kernel, 4);
+      return;
     }
-    else {
-      itgf.compute(func, ItgParam(r));
-      return 1 + 1.5 * itgf.getSolution()/r;
+    double dyMax = 0.0;
+    for (size_t i = 1; i < wvg_.size(); ++i) {
+      dyMax = max(dyMax, wvg_[i] - wvg_[i-1]);
     }
+    const size_t nNodes = 8 + static_cast<size_t>(ceil(r * dyMax));
+    auto kernel = [&](const double& y)->double{ return y * sin(r * y) / r; };
+    functional = make_shared<const SplineFunctional>(wvg_, kernel, nNodes);
+  }
+
+  double Rdf::get(const vector<double> &ssf) const {
+    return 1 + 1.5 * functional->eval(ssf, 1.0);
   }
   
 }
@@ -558,13 +661,153 @@ namespace parallelUtil {
   
   namespace MPI {
 
-    const MPI_Comm MPICommunicator = MPI_COMM_WORLD;
+    // Node level communicators for the ranks of a communicator
+    // (created on first use)
+    class NodeComm {
+    public:
+      MPI_Comm node = MPI_COMM_NULL;
+      MPI_Comm leaders = MPI_COMM_NULL;
+      // Rank in the leaders communicator of the leader of each rank
+      vector<int> leaderOf;
+      // Flag marking if at least one node hosts more than one rank
+      bool enabled = false;
+    };
+
+    // Communicator for a group of ranks
+    class Communicator {
+    public:
+      MPI_Comm comm = MPI_COMM_NULL;
+      NodeComm nodeComm;
+      // Number of windows allocated with allocateShared
+      int nWindows = 0;
+      // Rank of the root in the communicator with all the ranks
+      int root = 0;
+    };
+
+    // Communicators created with splitCommunicator (the first
+    // communicator contains all the ranks)
+    static deque<Communicator>& getCommunicators() {
+      static deque<Communicator> comms(1, Communicator{MPI_COMM_WORLD, NodeComm()});
+      return comms;
+    }
+
+    // Index of the communicator used by all the MPI calls
+    static int activeCommunicator = 0;
+
+    // Number of rank-local scopes opened by the calling thread
+    static thread_local int localScopes = 0;
+
+    // Level of thread support provided by the MPI library
+    static int threadSupport = MPI_THREAD_SINGLE;
+
+    // Check that the ranks are allowed to communicate
+    static void checkCommunication() {
+      assert(localScopes == 0);
+    }
+
+    static MPI_Comm getComm() {
+      return getCommunicators()[activeCommunicator].comm;
+    }
+
+    // Window for the memory allocated with allocateShared, index of
+    // the communicator used for the allocation and order of the
+    // allocation on that communicator
+    class SharedWindow {
+    public:
+      MPI_Win win;
+      int commId;
+      int id = 0;
+      // Flag marking that the memory is no longer used on this rank
+      bool unused = false;
+    };
+
+    static map<const double*, SharedWindow>& getWindows() {
+      static map<const double*, SharedWindow> windows;
+      return windows;
+    }
+
+    static NodeComm& getNodeComm(const int commId) {
+      auto& c = getCommunicators()[commId];
+      NodeComm& nc = c.nodeComm;
+      if (nc.node != MPI_COMM_NULL) { return nc; }
+      int thisRank;
+      int nRanks;
+      MPI_Comm_rank(c.comm, &thisRank);
+      MPI_Comm_size(c.comm, &nRanks);
+      MPI_Comm_split_type(c.comm, MPI_COMM_TYPE_SHARED,
+			  thisRank, MPI_INFO_NULL, &nc.node);
+      int thisNodeRank;
+      MPI_Comm_rank(nc.node, &thisNodeRank);
+      const bool leader = thisNodeRank == 0;
+      MPI_Comm_split(c.comm, leader ? 0 : MPI_UNDEFINED,
+		     thisRank, &nc.leaders);
+      int leaderRank = -1;
+      if (leader) { MPI_Comm_rank(nc.leaders, &leaderRank); }
+      MPI_Bcast(&leaderRank, 1, MPI_INT, 0, nc.node);
+      nc.leaderOf.resize(nRanks);
+      MPI_Allgather(&leaderRank, 1, MPI_INT,
+		    nc.leaderOf.data(), 1, MPI_INT, c.comm);
+      int thisNodeSize;
+      int maxNodeSize;
+      MPI_Comm_size(nc.node, &thisNodeSize);
+      MPI_Allreduce(&thisNodeSize, &maxNodeSize, 1, MPI_INT,
+		    MPI_MAX, c.comm);
+      nc.enabled = maxNodeSize > 1;
+      return nc;
+    }
+
+    static NodeComm& getNodeComm() {
+      return getNodeComm(activeCommunicator);
+    }
+
+    // The windows are freed only at collective calls (see releaseShared)
+    static void markSharedUnused(double* ptr) {
+      auto& windows = getWindows();
+      auto it = windows.find(ptr);
+      if (it != windows.end()) { it->second.unused = true; }
+    }
+
+    // Free the windows of a communicator. If unusedOnly is true, only
+    // the windows that are unused on all the ranks of the node are
+    // freed. Must be called by all the ranks of the communicator
+    static void releaseShared(const int commId,
+			      const bool unusedOnly) {
+      auto& windows = getWindows();
+      vector<map<const double*, SharedWindow>::iterator> toRelease;
+      for (auto it = windows.begin(); it != windows.end(); ++it) {
+	if (it->second.commId == commId) { toRelease.push_back(it); }
+      }
+      if (toRelease.empty()) { return; }
+      // Same order on all the ranks
+      sort(toRelease.begin(), toRelease.end(), [](const auto& a, const auto& b) {
+	return a->second.id < b->second.id;
+      });
+      vector<int> unused;
+      for (const auto& it : toRelease) { unused.push_back(!unusedOnly || it->second.unused); }
+      MPI_Allreduce(MPI_IN_PLACE, unused.data(), unused.size(), MPI_INT,
+		    MPI_MIN, getNodeComm(commId).node);
+      for (size_t k = 0; k < toRelease.size(); ++k) {
+	if (!unused[k]) { continue; }
+	MPI_Win win = toRelease[k]->second.win;
+	windows.erase(toRelease[k]);
+	MPI_Win_unlock_all(win);
+	MPI_Win_free(&win);
+      }
+    }
 
     void init() {
-      MPI_Init(nullptr, nullptr);
+      // The progress of the parallel loops is reported by any thread,
+      // one at a time (see parallelFor). The calculations run with a
+      // lower level of thread support if progress is not reported
+      MPI_Init_thread(nullptr, nullptr, MPI_THREAD_SERIALIZED, &threadSupport);
     }
 
     void finalize() {
+      // The windows are freed in the same order on all ranks
+      const int nComms = getCommunicators().size();
+      for (int commId = 0; commId < nComms; ++commId) {
+	releaseShared(commId, false);
+      }
       MPI_Finalize();
     }
     
@@ -576,18 +819,19 @@ namespace parallelUtil {
     
     int rank() {
       int rank;
-      MPI_Comm_rank(MPICommunicator, &rank);
+      MPI_Comm_rank(getComm(), &rank);
       return rank;
     }
   
     int numberOfRanks() {
       int numRanks;
-      MPI_Comm_size(MPICommunicator, &numRanks);
+      MPI_Comm_size(getComm(), &numRanks);
       return numRanks;
     }
 
     void barrier() {
-      MPI_Barrier(MPICommunicator);
+      checkCommunication();
+      MPI_Barrier(getComm());
     }
   
     bool isRoot() {
@@ -609,7 +853,7 @@ namespace parallelUtil {
     }
   
     void abort() {
-      MPI_Abort(MPICommunicator, 1);
+      MPI_Abort(getComm(), 1);
     }
 
     double timer() {
@@ -617,12 +861,221 @@ namespace parallelUtil {
     }
 
     bool isEqualOnAllRanks(const int& myNumber) {
+      checkCommunication();
       int globalMininumNumber;
       MPI_Allreduce(&myNumber, &globalMininumNumber, 1,
-		    MPI_INT, MPI_MIN, MPICommunicator);
+		    MPI_INT, MPI_MIN, getComm());
       return myNumber == globalMininumNumber;
     }
   
+    int nodeRank() {
+      int rank;
+      MPI_Comm_rank(getNodeComm().node, &rank);
+      return rank;
+    }
+
+    int numberOfNodeRanks() {
+      int numRanks;
+      MPI_Comm_size(getNodeComm().node, &numRanks);
+      return numRanks;
+    }
+
+    bool isNodeLeader() {
+      return nodeRank() == 0;
+    }
+
+    void nodeBarrier() {
+      checkCommunication();
+      MPI_Barrier(getNodeComm().node);
+    }
+
+    // Make the writes to a shared window visible to all the ranks on the node
+    static void syncWindow(const SharedWindow& sw) {
+      checkCommunication();
+      MPI_Win_sync(sw.win);
+      MPI_Barrier(getNodeComm(sw.commId).node);
+      MPI_Win_sync(sw.win);
+    }
+
+    void syncShared(const double* data) {
+      const auto& windows = getWindows();
+      const auto it = windows.find(data);
+      if (it != windows.end()) { syncWindow(it->second); }
+    }
+
+    // Allocate memory shared among the ranks on the same node. The
+    // memory is initialized by calling init on all the ranks of the node
+    static shared_ptr<double> allocateShared(const size_t n,
+					     const function<void(double*)>& init) {
+      checkCommunication();
+      if (!getNodeComm().enabled) {
+	double* ptr = static_cast<double*>(vecUtil::allocateAligned(n * sizeof(double)));
+	init(ptr);
+	return shared_ptr<double>(ptr, vecUtil::freeAligned);
+      }
+      releaseShared(activeCommunicator, true);
+      // Only the leader allocates memory, all other ranks on the node
+      // get a pointer to the memory of the leader
+      const bool leader = isNodeLeader();
+      const MPI_Aint bytes = (leader) ? n * sizeof(double) : 0;
+      double* ptr;
+      SharedWindow sw;
+      sw.commId = activeCommunicator;
+      sw.id = getCommunicators()[activeCommunicator].nWindows++;
+      MPI_Win_allocate_shared(bytes, sizeof(double), MPI_INFO_NULL,
+			      getNodeComm().node, &ptr, &sw.win);
+      if (!leader) {
+	MPI_Aint leaderBytes;
+	int dispUnit;
+	MPI_Win_shared_query(sw.win, 0, &leaderBytes, &dispUnit, &ptr);
+      }
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, sw.win);
+      init(ptr);
+      syncWindow(sw);
+      getWindows()[ptr] = sw;
+      return shared_ptr<double>(ptr, markSharedUnused);
+    }
+
+    shared_ptr<double> allocateShared(const size_t n) {
+      const bool leader = !getNodeComm().enabled || isNodeLeader();
+      return allocateShared(n, [&](double* ptr) {
+	if (leader) { std::fill(ptr, ptr + n, 0.0); }
+      });
+    }
+
+    // Memory pages are mapped to the NUMA node of the thread that
+    // first writes to them. Hence the iterations run by this rank are
+    // initialized by the same threads that run them in parallelFor
+    shared_ptr<double> allocateShared(const size_t n,
+				      const int loopSize,
+				      const int ompThreads) {
+      assert(loopSize > 0 && n % loopSize == 0);
+      const size_t countsPerLoop = n / loopSize;
+      const MPIParallelForData allIdx = getAllLoopIndexes(loopSize);
+      const int thisRank = rank();
+      const bool shared = getNodeComm().enabled;
+      const vector<int>& leaderOf = getNodeComm().leaderOf;
+      auto zero = [&](double* ptr, const int r, const int nThreads) {
+	const bool useOMP = nThreads > 1;
+	#pragma omp parallel for num_threads(nThreads) if (useOMP)
+	for (int i = allIdx[r].first; i < allIdx[r].second; ++i) {
+	  std::fill(ptr + i * countsPerLoop, ptr + (i + 1) * countsPerLoop, 0.0);
+	}
+      };
+      return allocateShared(n, [&](double* ptr) {
+	// The iterations of the ranks on other nodes are initialized
+	// by the leader of the node (or by each rank if the memory is
+	// not shared)
+	const bool leader = !shared || isNodeLeader();
+	for (size_t r = 0; r < allIdx.size(); ++r) {
+	  const bool sameNode = shared && leaderOf[r] == leaderOf[thisRank];
+	  if (static_cast<int>(r) == thisRank) { zero(ptr, r, ompThreads); }
+	  else if (leader && !sameNode) { zero(ptr, r, 1); }
+	}
+      });
+    }
+
+    int splitCommunicator(const int color) {
+      checkCommunication();
+      MPI_Comm newComm;
+      MPI_Comm_split(getComm(), color, rank(), &newComm);
+      // The ranks are ordered as in the communicator with all the
+      // ranks, hence the root has the smallest rank
+      int worldRank;
+      int root;
+      MPI_Comm_rank(getCommunicators()[0].comm, &worldRank);
+      MPI_Allreduce(&worldRank, &root, 1, MPI_INT, MPI_MIN, newComm);
+      auto& comms = getCommunicators();
+      Communicator c{newComm, NodeComm()};
+      c.root = root;
+      comms.push_back(c);
+      return comms.size() - 1;
+    }
+
+    int groupRoot() {
+      return getCommunicators()[activeCommunicator].root;
+    }
+
+    // The identifiers of the freed communicators are not reused
+    void freeCommunicator(const int commId) {
+      checkCommunication();
+      const int nComms = getCommunicators().size();
+      if (commId <= 0 || commId >= nComms
+	  || getCommunicators()[commId].comm == MPI_COMM_NULL) {
+	throwError("Invalid communicator: " + to_string(commId));
+      }
+      if (commId == activeCommunicator) {
+	throwError("The active communicator can't be freed");
+      }
+      releaseShared(commId, false);
+      auto& c = getCommunicators()[commId];
+      if (c.nodeComm.leaders != MPI_COMM_NULL) { MPI_Comm_free(&c.nodeComm.leaders); }
+      if (c.nodeComm.node != MPI_COMM_NULL) { MPI_Comm_free(&c.nodeComm.node); }
+      MPI_Comm_free(&c.comm);
+      c = Communicator();
+    }
+
+    int getCommunicator() {
+      return activeCommunicator;
+    }
+
+    void setCommunicator(const int commId) {
+      const int nComms = getCommunicators().size();
+      if (commId < 0 || commId >= nComms
+	  || getCommunicators()[commId].comm == MPI_COMM_NULL) {
+	throwError("Invalid communicator: " + to_string(commId));
+      }
+      activeCommunicator = commId;
+    }
+
+    CommunicatorScope::CommunicatorScope(const int commId)
+      : previous(getCommunicator()) {
+      setCommunicator(commId);
+    }
+
+    CommunicatorScope::~CommunicatorScope() {
+      activeCommunicator = previous;
+    }
+
+    LocalScope::LocalScope() {
+      ++localScopes;
+    }
+
+    LocalScope::~LocalScope() {
+      --localScopes;
+    }
+
+    void broadcast(double* data,
+		   const int count,
+		   const int root) {
+      checkCommunication();
+      MPI_Bcast(data, count, MPI_DOUBLE, root, getComm());
+    }
+
+    void broadcast(int* data,
+		   const int count,
+		   const int root) {
+      checkCommunication();
+      MPI_Bcast(data, count, MPI_INT, root, getComm());
+    }
+
+    void exchangeMessages(const vector<Message>& toSend,
+			  const vector<Message>& toRecv) {
+      checkCommunication();
+      vector<MPI_Request> requests;
+      for (const auto& m : toRecv) {
+	requests.push_back(MPI_REQUEST_NULL);
+	MPI_Irecv(m.data, m.count, MPI_DOUBLE, m.rank, m.tag,
+		  getComm(), &requests.back());
+      }
+      for (const auto& m : toSend) {
+	requests.push_back(MPI_REQUEST_NULL);
+	MPI_Isend(m.data, m.count, MPI_DOUBLE, m.rank, m.tag,
+		  getComm(), &requests.back());
+      }
+      MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    }
+
     pair<int, int> getLoopIndexes(const int loopSize,
 				  const int thisRank) {
       pair<int, int> idx = {0, loopSize};
@@ -644,37 +1097,319 @@ namespace parallelUtil {
       return out;
     }
 
+    // Progress of a parallel for loop. The threads count the completed
+    // indexes with atomic updates. At most every interval seconds the
+    // first thread that completes an index sends the count to the root
+    // (the reports are serialized with a critical section and the
+    // interval is checked without MPI calls), which
+    // prints the progress in plain text and in JSON format. The
+    // remaining time is estimated from the cost per index observed on
+    // each rank, the rank that finishes last determines the estimate
+    class LoopProgress {
+    public:
+      LoopProgress(const string& label_,
+		   const double& interval_,
+		   const MPIParallelForData& loopData);
+      // Count one completed index
+      void update();
+      // Collect the final counts of all the ranks
+      void finish();
+    private:
+      static constexpr int tag = 32000;
+      const string label;
+      const double interval;
+      const double start;
+      const int thisRank;
+      const int nRanks;
+      vector<int> rankSize;
+      atomic<int> done;
+      // Time of the last report (from omp_get_wtime, not from MPI)
+      atomic<double> lastReport;
+      // Used by one thread at a time
+      bool printed;
+      // Counts, elapsed times and time of the last message for each rank
+      // and number of ranks that sent the final count (root only)
+      vector<int> rankDone;
+      vector<double> rankElapsed;
+      vector<double> rankUpdate;
+      int nFinal;
+      // Message sent to the root (non-root ranks only)
+      array<double, 3> msg;
+      MPI_Request request;
+      void send(const bool isFinal);
+      void receive(const int source);
+      void receiveAvailable();
+      void print();
+    };
+
+    LoopProgress::LoopProgress(const string& label_,
+			       const double& interval_,
+			       const MPIParallelForData& loopData)
+      : label(label_), interval(interval_), start(timer()),
+	thisRank(rank()), nRanks(loopData.size()), done(0),
+	lastReport(omp_get_wtime()), printed(false), rankDone(nRanks, 0),
+	rankElapsed(nRanks, 0.0), rankUpdate(nRanks, start), nFinal(0),
+	request(MPI_REQUEST_NULL) {
+      for (const auto& idx : loopData) {
+	rankSize.push_back(idx.second - idx.first);
+      }
+    }
+
+    void LoopProgress::update() {
+      done.fetch_add(1, memory_order_relaxed);
+      if (omp_get_wtime() - lastReport.load(memory_order_relaxed) < interval) { return; }
+      #pragma omp critical(loopProgress)
+      {
+	const double now = omp_get_wtime();
+	if (now - lastReport.load() >= interval) {
+	  lastReport = now;
+	  if (thisRank == 0) {
+	    receiveAvailable();
+	    print();
+	  }
+	  else {
+	    send(false);
+	  }
+	}
+      }
+    }
+
+    void LoopProgress::finish() {
+      if (thisRank != 0) {
+	send(true);
+	return;
+      }
+      while (nFinal < nRanks - 1) {
+	MPI_Status status;
+	MPI_Probe(MPI_ANY_SOURCE, tag, getComm(), &status);
+	receive(status.MPI_SOURCE);
+	if (nFinal < nRanks - 1 && omp_get_wtime() - lastReport >= interval) {
+	  lastReport = omp_get_wtime();
+	  print();
+	}
+      }
+      print();
+    }
+
+    // The previous message is skipped if it was not delivered yet
+    void LoopProgress::send(const bool isFinal) {
+      if (isFinal) {
+	MPI_Wait(&request, MPI_STATUS_IGNORE);
+      }
+      else if (request != MPI_REQUEST_NULL) {
+	int completed;
+	MPI_Test(&request, &completed, MPI_STATUS_IGNORE);
+	if (!completed) { return; }
+      }
+      msg = {static_cast<double>(done.load()), timer() - start,
+	     static_cast<double>(isFinal)};
+      if (isFinal) {
+	MPI_Send(msg.data(), msg.size(), MPI_DOUBLE, 0, tag, getComm());
+	return;
+      }
+      MPI_Isend(msg.data(), msg.size(), MPI_DOUBLE, 0, tag, getComm(), &request);
+    }
+
+    void LoopProgress::receive(const int source) {
+      array<double, 3> buffer;
+      MPI_Recv(buffer.data(), buffer.size(), MPI_DOUBLE, source, tag,
+	       getComm(), MPI_STATUS_IGNORE);
+      rankDone[source] = buffer[0];
+      rankElapsed[source] = buffer[1];
+      rankUpdate[source] = timer();
+      if (buffer[2] != 0.0) { ++nFinal; }
+    }
+
+    void LoopProgress::receiveAvailable() {
+      int available = 1;
+      while (available) {
+	MPI_Status status;
+	MPI_Iprobe(MPI_ANY_SOURCE, tag, getComm(), &available, &status);
+	if (available) { receive(status.MPI_SOURCE); }
+      }
+    }
+
+    void LoopProgress::print() {
+      const double now = timer();
+      rankDone[0] = done.load();
+      rankElapsed[0] = now - start;
+      rankUpdate[0] = now;
+      int nDone = 0;
+      int nTotal = 0;
+      double remaining = 0.0;
+      int slowest = 0;
+      string ranks;
+      for (int r = 0; r < nRanks; ++r) {
+	const double age = now - rankUpdate[r];
+	double rankRemaining = 0.0;
+	if (rankDone[r] < rankSize[r]) {
+	  rankRemaining = (rankDone[r] > 0)
+	    ? (rankSize[r] - rankDone[r]) * rankElapsed[r] / rankDone[r] - age
+	    : numUtil::Inf;
+	  rankRemaining = max(rankRemaining, 0.0);
+	}
+	if (rankRemaining > remaining) {
+	  remaining = rankRemaining;
+	  slowest = r;
+	}
+	nDone += rankDone[r];
+	nTotal += rankSize[r];
+	ranks += fmt::format("{}{{\"rank\": {}, \"done\": {}, \"total\": {}, \"age\": {:.1f}}}",
+			     (r > 0) ? ", " : "", r, rankDone[r], rankSize[r], age);
+      }
+      const double percent = (nTotal > 0) ? 100.0 * nDone / nTotal : 100.0;
+      const bool known = isfinite(remaining);
+      if (!printed) { cout << endl; }
+      printed = true;
+      cout << fmt::format("Progress of the {}: {}/{} ({:.1f}%), elapsed {:.1f} s, "
+			  "remaining {}, slowest rank {}",
+			  label, nDone, nTotal, percent, now - start,
+			  (known) ? fmt::format("{:.1f} s", remaining) : "unknown",
+			  slowest) << endl;
+      cout << fmt::format("{{\"progress\": \"{}\", \"done\": {}, \"total\": {}, "
+			  "\"elapsed\": {:.1f}, \"remaining\": {}, \"ranks\": [{}]}}",
+			  label, nDone, nTotal, now - start,
+			  (known) ? fmt::format("{:.1f}", remaining) : "null",
+			  ranks) << endl;
+    }
+
     MPIParallelForData parallelFor(const function<void(int)>& loopFunc,
 				   const int loopSize,
-				   const int ompThreads) {
+				   const int ompThreads,
+				   const string& progressLabel,
+				   const double progressInterval) {
+      checkCommunication();
       MPIParallelForData allIdx = getAllLoopIndexes(loopSize);
       const auto& thisIdx = allIdx[rank()];
       const bool useOMP = ompThreads > 1;
+      if (progressInterval <= 0.0) {
+	#pragma omp parallel for num_threads(ompThreads) if (useOMP)
+	for (int i=thisIdx.first; i<thisIdx.second; ++i) {
+	  loopFunc(i);
+	}
+	return allIdx;
+      }
+      if (threadSupport < MPI_THREAD_SERIALIZED) {
+	throwError("The progress can be reported only if the MPI library"
+		   " supports MPI_THREAD_SERIALIZED");
+      }
+      LoopProgress progress(progressLabel, progressInterval, allIdx);
       #pragma omp parallel for num_threads(ompThreads) if (useOMP)
       for (int i=thisIdx.first; i<thisIdx.second; ++i) {
 	loopFunc(i);
+	progress.update();
       }
+      progress.finish();
       return allIdx;
     }
   
-    void gatherLoopData(double* dataToGather,
-			const MPIParallelForData& loopData,
-			const int countsPerLoop) {
-      std::vector<int> recieverCounts;
+    // Number of elements and displacements for the data gathered from a loop
+    static void getGatherCounts(const MPIParallelForData& loopData,
+				const int countsPerLoop,
+				vector<int>& counts,
+				vector<int>& displacements) {
+      counts.clear();
       for (const auto& i : loopData) {
 	const int loopSpan = i.second - i.first;
-	recieverCounts.push_back(loopSpan * countsPerLoop);
+	counts.push_back(loopSpan * countsPerLoop);
       }
-      std::vector<int> displacements(recieverCounts.size(), 0);
-      std::partial_sum(recieverCounts.begin(),
-		       recieverCounts.end()-1,
+      displacements.assign(counts.size(), 0);
+      std::partial_sum(counts.begin(),
+		       counts.end()-1,
 		       displacements.begin()+1,
 		       plus<double>());
-      MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
-		     dataToGather,
-		     recieverCounts.data(),
-		     displacements.data(),
-		     MPI_DOUBLE, MPI_COMM_WORLD);
+    }
+  
+    void gatherLoopData(double* dataToGather,
+			const MPIParallelForData& loopData,
+			const int countsPerLoop) {
+      gatherLoopDataAsync(dataToGather, loopData, countsPerLoop).wait();
+    }
+
+    // The request and the arrays with the counts must remain valid
+    // until the communication is completed
+    class GatherRequest::Impl {
+    public:
+      vector<MPI_Request> requests;
+      vector<int> counts;
+      vector<int> displacements;
+      // Window used if the data is in memory shared among the node ranks
+      MPI_Win win = MPI_WIN_NULL;
+      int commId = 0;
+    };
+
+    GatherRequest::GatherRequest() = default;
+
+    GatherRequest::GatherRequest(unique_ptr<Impl> impl_) : impl(std::move(impl_)) { ; }
+
+    GatherRequest::GatherRequest(GatherRequest&& other) = default;
+
+    GatherRequest& GatherRequest::operator=(GatherRequest&& other) {
+      if (this != &other) {
+	wait();
+	impl = std::move(other.impl);
+      }
+      return *this;
+    }
+
+    GatherRequest::~GatherRequest() {
+      wait();
+    }
+
+    void GatherRequest::wait() {
+      if (!impl) { return; }
+      MPI_Waitall(impl->requests.size(), impl->requests.data(),
+		  MPI_STATUSES_IGNORE);
+      if (impl->win != MPI_WIN_NULL) { syncWindow({impl->win, impl->commId}); }
+      impl.reset();
+    }
+
+    bool GatherRequest::test() {
+      if (!impl) { return true; }
+      // The completion of a gather in shared memory requires a
+      // barrier among the node ranks, hence it is never tested
+      if (impl->win != MPI_WIN_NULL) { return false; }
+      int flag;
+      MPI_Testall(impl->requests.size(), impl->requests.data(),
+		  &flag, MPI_STATUSES_IGNORE);
+      if (flag) { impl.reset(); }
+      return flag;
+    }
+
+    GatherRequest gatherLoopDataAsync(double* dataToGather,
+				      const MPIParallelForData& loopData,
+				      const int countsPerLoop) {
+      checkCommunication();
+      auto impl = make_unique<GatherRequest::Impl>();
+      getGatherCounts(loopData, countsPerLoop, impl->counts, impl->displacements);
+      const auto& windows = getWindows();
+      const auto win = windows.find(dataToGather);
+      if (win == windows.end()) {
+	impl->requests.resize(1);
+	MPI_Iallgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+			dataToGather,
+			impl->counts.data(),
+			impl->displacements.data(),
+			MPI_DOUBLE, getComm(), impl->requests.data());
+	return GatherRequest(std::move(impl));
+      }
+      // Data in shared memory: the ranks on each node have already
+      // written their results in the same buffer, so the node leaders
+      // only have to exchange the data computed on the other nodes
+      impl->win = win->second.win;
+      impl->commId = win->second.commId;
+      syncWindow(win->second);
+      const NodeComm& nc = getNodeComm(impl->commId);
+      if (nc.leaders != MPI_COMM_NULL) {
+	for (size_t i = 0; i < impl->counts.size(); ++i) {
+	  if (impl->counts[i] == 0) { continue; }
+	  impl->requests.push_back(MPI_REQUEST_NULL);
+	  MPI_Ibcast(dataToGather + impl->displacements[i], impl->counts[i],
+		     MPI_DOUBLE, nc.leaderOf[i], nc.leaders,
+		     &impl->requests.back());
+	}
+      }
+      return GatherRequest(std::move(impl));
     }
   
 }
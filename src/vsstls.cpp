@@ -4,6 +4,7 @@
 #include "vsstls.hpp"
 
 using namespace std;
+using namespace parallelUtil;
 
 // -----------------------------------------------------------------
 // VSStls class
@@ -58,27 +59,35 @@ void StructProp::doIterations() {
   int counter = 0;
   // Define initial guess
   for (auto& c : csr) { c.initialGuess(); }
-  // Iteration to solve for the structural properties
+  // Iteration to solve for the structural properties. The state points
+  // are distributed among the MPI ranks and, within each rank, among
+  // the OpenMP threads. The work on each state point does not
+  // communicate with the other ranks
   const bool useOMP = ompThreads > 1;
+  const int nLocal = localCsr.size();
   while (counter < maxIter+1 && err > minErr ) {
     // Compute new solution and error
-    #pragma omp parallel num_threads(ompThreads) if (useOMP)
-    {
-      #pragma omp for
-      for (auto& c : csr) {
-	c.computeSsf();
-	c.computeSlfcStls();
-      }
-      #pragma omp for
-      for (size_t i = 0; i < csr.size(); ++i) {
-	auto& c = csr[i];
-	c.computeSlfc();
-	if (i == RS_THETA) { err = c.computeError(); }
-	c.updateSolution();
-      }
+    #pragma omp parallel for num_threads(ompThreads) if (useOMP)
+    for (int k = 0; k < nLocal; ++k) {
+      MPI::LocalScope localScope;
+      auto& c = csr[localCsr[k]];
+      c.computeSsf();
+      c.computeSlfcStls();
     }
+    exchangeLfc();
+    #pragma omp parallel for num_threads(ompThreads) if (useOMP)
+    for (int k = 0; k < nLocal; ++k) {
+      MPI::LocalScope localScope;
+      const size_t i = localCsr[k];
+      auto& c = csr[i];
+      c.computeSlfc();
+      if (i == RS_THETA) { err = c.computeError(); }
+      c.updateSolution();
+    }
+    broadcastError(err);
     counter++;
   }
+  broadcastSolution();
   if (verbose) {
     printf("Alpha = %.5e, Residual error "
 	   "(structural properties) = %.5e\n",
@@ -90,6 +99,11 @@ void StructProp::doIterations() {
 // StlsCSR class
 // -----------------------------------------------------------------
 
+void StlsCSR::broadcastSolution(const int root) {
+  MPI::broadcast(ssf.data(), ssf.size(), root);
+  MPI::broadcast(slfc.data(), slfc.size(), root);
+}
+
 void StlsCSR::computeSlfcStls() {
   Stls::computeSlfc();
   *lfc = slfcNew;